@@ -1,44 +1,19 @@
-QT       += core gui
-
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
-
-CONFIG += c++17
-
-# You can make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-SOURCES += \
-    src/DeckSetup.cpp \
-    src/cards.cpp \
-    src/dealer.cpp \
-    src/gameui.cpp \
-    src/main.cpp \
-    src/mainwindow.cpp \
-    src/player.cpp \
-    src/startmenu.cpp \
-    src/wallet.cpp
-
-HEADERS += \
-    headers/DeckSetup.h \
-    headers/cards.h \
-    headers/dealer.h \
-    headers/gameui.h \
-    headers/mainwindow.h \
-    headers/player.h \
-    headers/startmenu.h \
-    headers/wallet.h
-
-FORMS += \
-    forms/mainwindow.ui
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
-
-RESOURCES += \
-    resources/images.qrc
+TEMPLATE = subdirs
+
+# core:     Qt-free game logic (deck, hands, dealer, settlement) as a static library.
+# app:      the Qt GUI.
+# headless: console simulator that links only the core library.
+SUBDIRS += \
+    core \
+    app \
+    headless
+
+core.file = core/core.pro
+app.file = app.pro
+headless.file = headless/headless.pro
+
+app.depends = core
+headless.depends = core
 
 DISTFILES += \
     README.md
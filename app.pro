@@ -0,0 +1,37 @@
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = BlackjackSimulator
+
+include(core/link.pri)
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+SOURCES += \
+    src/cards.cpp \
+    src/gameui.cpp \
+    src/main.cpp \
+    src/mainwindow.cpp \
+    src/qtadapter.cpp \
+    src/startmenu.cpp
+
+HEADERS += \
+    headers/cards.h \
+    headers/gameui.h \
+    headers/mainwindow.h \
+    headers/qtadapter.h \
+    headers/startmenu.h
+
+FORMS += \
+    forms/mainwindow.ui
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+RESOURCES += \
+    resources/images.qrc
@@ -0,0 +1,16 @@
+# Settings shared by the core library and every project that uses it.
+
+CONFIG += c++17 thread
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+# Log levels below BJ_LOG_LEVEL are compiled out (see headers/log.h).
+CONFIG(debug, debug|release): DEFINES += BJ_LOG_LEVEL=BJ_LOG_LEVEL_DEBUG
+else: DEFINES += BJ_LOG_LEVEL=BJ_LOG_LEVEL_WARN
+
+# Build with CONFIG+=trace to compile in TRACE_SCOPE spans (see headers/trace.h).
+trace: DEFINES += BJ_TRACE
+
+# Build with CONFIG+=count_allocations to count heap allocations in the metrics export.
+count_allocations: DEFINES += BJ_METRICS_COUNT_ALLOCATIONS
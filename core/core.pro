@@ -0,0 +1,63 @@
+# Game logic with no Qt dependency, linked by both the GUI and the headless simulator.
+
+TEMPLATE = lib
+TARGET = core
+CONFIG += staticlib
+CONFIG -= qt
+
+include(core.pri)
+
+SOURCES += \
+    src/DeckSetup.cpp \
+    src/advisor.cpp \
+    src/analyzer.cpp \
+    src/betting.cpp \
+    src/cache.cpp \
+    src/checkpoint.cpp \
+    src/composition.cpp \
+    src/dealer.cpp \
+    src/dealerprob.cpp \
+    src/deviations.cpp \
+    src/handvalue.cpp \
+    src/log.cpp \
+    src/metrics.cpp \
+    src/player.cpp \
+    src/processpool.cpp \
+    src/removal.cpp \
+    src/rules.cpp \
+    src/sampler.cpp \
+    src/sketch.cpp \
+    src/stats.cpp \
+    src/strategy.cpp \
+    src/table.cpp \
+    src/trace.cpp \
+    src/wallet.cpp
+
+HEADERS += \
+    headers/DeckSetup.h \
+    headers/advisor.h \
+    headers/analyzer.h \
+    headers/betting.h \
+    headers/cache.h \
+    headers/checkpoint.h \
+    headers/composition.h \
+    headers/counting.h \
+    headers/dealer.h \
+    headers/dealerprob.h \
+    headers/deviations.h \
+    headers/engine.h \
+    headers/hand.h \
+    headers/handvalue.h \
+    headers/log.h \
+    headers/metrics.h \
+    headers/player.h \
+    headers/processpool.h \
+    headers/removal.h \
+    headers/rules.h \
+    headers/sampler.h \
+    headers/sketch.h \
+    headers/stats.h \
+    headers/strategy.h \
+    headers/table.h \
+    headers/trace.h \
+    headers/wallet.h
@@ -0,0 +1,137 @@
+#ifndef DECKSETUP_H
+#define DECKSETUP_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "headers/counting.h"
+
+class SnapshotReader;
+class SnapshotWriter;
+
+/**
+ * @file DeckSetup.h
+ * @brief Header file defining card game elements.
+ *
+ * This file contains the enums, structs, and classes necessary to set up and manage a card deck for games.
+ * It has no Qt dependency; display text and image paths for cards live in the GUI's qtadapter.h.
+ * @author Hsiao Yuan Lu
+ */
+
+
+
+/**
+ * @enum CardNames
+ * @brief Enumerates all possible card names.
+ */
+enum CardNames { ACE, TWO, THREE, FOUR, FIVE, SIX, SEVEN, EIGHT, NINE, TEN, JACK, QUEEN, KING };
+
+/**
+ * @enum Suits
+ * @brief Enumerates card suits.
+ */
+enum Suits {
+    CLUBS,
+    DIAMONDS,
+    HEARTS,
+    SPADES,
+    // Add more suits as needed
+};
+
+
+/**
+ * @struct Card
+ * @brief Represents a single playing card.
+ * A card consists of a name, suit, and numerical value. It includes methods to print and retrieve card details.
+ */
+struct Card {
+    CardNames name;
+    Suits suit;
+    int value;
+
+    bool isAce() const; /// Checks if the card is an Ace.
+
+    const char *rankName() const; /// Name of the card's rank, e.g. "Ace", "7" or "King".
+    const char *suitName() const; /// Name of the card's suit, e.g. "Clubs".
+};
+
+/**
+ * @class Deck
+ * @brief Represents a standard deck of 52 playing cards.
+ * This class is responsible for generating and managing a standard deck of playing cards.
+ */
+class Deck {
+public:
+    Card arrCards[52];
+    void generateDeck();
+};
+
+/**
+ * @class MultiDeck
+ * @brief A shoe of several shuffled decks dealt from the front.
+ *
+ * Cards are dealt by advancing a cursor through allDecks, so the cards still to be dealt
+ * are allDecks[nextCard] onwards. Each instance keeps its own cursor, so independent shoes
+ * can be used side by side. Every card dealt is also fed to the shoe's CardCounter.
+ *
+ * Each shoe also has its own random generator, seeded from std::random_device unless
+ * seed() is called. Shuffles only depend on the seed and how many shuffles came before, so
+ * two shoes given the same seed deal the same sequence of shoes however differently they
+ * are played; loadShoe() deals an order shuffled elsewhere instead.
+ *
+ * With antithetic set, every second shuffle deals the previous order reversed instead of a
+ * new one, giving pairs of shoes with the same distribution whose results can be averaged.
+ */
+class MultiDeck {
+public:
+    explicit MultiDeck(int decks = 6)
+        : deckCount(decks), allDecks(decks * 52), counts(decks), rng(std::random_device{}()) {}
+
+    std::vector<Card> drawnCards;
+    int deckCount;              /// Number of 52-card decks in the shoe.
+    std::vector<Card> allDecks;
+    int nextCard = 0;           /// Index in allDecks of the next card to be dealt.
+    CardCounter counts;         /// Counts of the cards dealt since the last shuffle.
+    bool antithetic = false;    /// Pair each shuffled order with its reverse.
+
+    void shuffle(Card *decks, int size);
+    void createAndShuffleDecks();
+
+    /// Reshuffles a full shoe less the given cards, which are dealt from it at once, for a
+    /// round that runs dry while those cards are still on the table.
+    void shuffleDiscards(const std::vector<Card>& inPlay);
+    void setDeckCount(int decks);
+    Card drawCard();
+
+    /// Restarts the shoe's random generator, so the shuffles that follow are reproducible.
+    void seed(std::uint64_t value);
+
+    /// Starts dealing a copy of another shoe's order; it must hold as many cards as this one.
+    void loadShoe(const std::vector<Card>& order);
+
+    /// Saves the order, cursor, counts and random generator, everything later deals depend on.
+    void save(SnapshotWriter& snapshot) const;
+
+    /// Restores a save() of a shoe with as many decks; returns false if it is not one.
+    bool restore(SnapshotReader& snapshot);
+
+    int size() const { return (int) allDecks.size(); } /// Number of cards in the full shoe.
+    int remaining() const { return size() - nextCard; } /// Number of cards left to deal.
+    bool needsShuffle(double penetration) const;
+
+private:
+    std::mt19937 rng;
+    bool mirrorNext = false;    /// The next shuffle reverses the current order.
+};
+
+
+/// Seed of one of many independent streams derived from a base seed (a splitmix64 step).
+inline std::uint64_t streamSeed(std::uint64_t base, std::uint64_t stream) {
+    std::uint64_t z = base + (stream + 1) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+#endif // DECKSETUP_H
+
@@ -0,0 +1,90 @@
+#ifndef ADVISOR_H
+#define ADVISOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "headers/analyzer.h"
+#include "headers/composition.h"
+#include "headers/hand.h"
+#include "headers/rules.h"
+
+/**
+ * @file advisor.h
+ * @brief Exact action values for the hand being played, worked out in the background.
+ *
+ * Advisor owns one worker thread and one HandAnalyzer per upcard, kept warm between
+ * requests: after the first decision of a hand, every later decision is a node the first
+ * calculation already memoized. Only the latest request matters, so a new one cancels the
+ * calculation in progress. Answers are cached on the unseen cards, the hand and the upcard,
+ * so a situation that comes round again is answered at once on the caller's thread.
+ */
+
+
+/**
+ * @struct AdvisorQuery
+ * @brief A decision to evaluate.
+ */
+struct AdvisorQuery {
+    ShoeComposition shoe;         /// Unseen cards: the shoe left plus the hole card.
+    int upcard = 0;               /// Rank index of the dealer's upcard.
+    int ranks[MAX_HAND_CARDS] = {};
+    int count = 0;
+    bool fromSplit = false;
+
+    void addCard(const Card& card) { ranks[count++] = rankIndex(card); }
+
+    /// Identifies the situation: the unseen cards plus everything evaluate() looks at.
+    CompositionKey key() const;
+};
+
+
+/**
+ * @class Advisor
+ * @brief Background, cancellable, cached evaluation of AdvisorQuery decisions.
+ */
+class Advisor {
+public:
+    /// Called on the worker thread with each finished, uncancelled query and its values.
+    using Callback = std::function<void(const AdvisorQuery&, const ActionValues&)>;
+
+    Advisor(const RuleSet& rules, Callback ready);
+    ~Advisor();
+
+    Advisor(const Advisor&) = delete;
+    Advisor& operator=(const Advisor&) = delete;
+
+    /// Fills values and returns true if the situation has been worked out before.
+    bool lookup(const AdvisorQuery& query, ActionValues& values);
+
+    /// Starts on a query, replacing any waiting one and cancelling the one in progress.
+    void request(const AdvisorQuery& query);
+
+    /// Drops the waiting query and cancels the one in progress, if any.
+    void cancel();
+
+private:
+    void run();
+
+    RuleSet rules;
+    Callback ready;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    AdvisorQuery pending;
+    bool hasPending = false;
+    bool stopping = false;
+    std::atomic<bool> cancelled{false};
+    std::unordered_map<CompositionKey, ActionValues, CompositionKeyHash> cache;
+
+    std::unique_ptr<HandAnalyzer> analyzers[RANKS]; /// Only touched by the worker.
+    std::thread worker;
+};
+
+
+#endif // ADVISOR_H
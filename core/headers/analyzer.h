@@ -0,0 +1,153 @@
+#ifndef ANALYZER_H
+#define ANALYZER_H
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <unordered_map>
+#include "headers/composition.h"
+#include "headers/dealerprob.h"
+#include "headers/engine.h"
+#include "headers/rules.h"
+
+/**
+ * @file analyzer.h
+ * @brief Exact combinatorial analysis of player decisions.
+ *
+ * HandAnalyzer works out the exact expected value of standing, hitting, doubling, splitting
+ * and surrendering a hand against one dealer upcard, drawing from a finite ShoeComposition.
+ * Hitting is followed by the best hit-or-stand play on every later card. Hands are reduced
+ * to the rank counts left in the shoe plus the hand's hard total, so suits, ten-card ranks
+ * and card order never multiply the work, and every result is memoized on that key.
+ *
+ * Splitting is evaluated as two hands that each play on from one card of the pair, with
+ * both pair cards out of the shoe: doubling after a split follows the DAS rule, split
+ * aces follow the hit-split-aces rule, and resplitting is not considered.
+ *
+ * analyzeShoe() runs one analyzer per upcard on a pool of threads and combines them into
+ * the expected value of a whole round under composition-dependent optimal play.
+ */
+
+
+/**
+ * @struct ActionValues
+ * @brief Expected value of each action, in units of the original bet.
+ */
+struct ActionValues {
+    double stand = 0.0;
+    double hit = 0.0;
+    double doubleDown = 0.0;
+    double split = 0.0;
+    double surrender = -0.5;
+    bool canDouble = false;
+    bool canSplit = false;
+    bool canSurrender = false;
+
+    /// The action with the highest expected value among those available.
+    Action best() const;
+
+    /// Expected value of best().
+    double bestValue() const;
+};
+
+
+/**
+ * @struct AnalysisCancelled
+ * @brief Thrown out of a HandAnalyzer whose cancel flag was raised mid-calculation.
+ *
+ * Only finished results are memoized, so the analyzer stays usable afterwards.
+ */
+struct AnalysisCancelled : std::runtime_error {
+    AnalysisCancelled() : std::runtime_error("analysis cancelled") {}
+};
+
+
+/**
+ * @class HandAnalyzer
+ * @brief Memoized exact evaluation of hands against one dealer upcard.
+ *
+ * Under peek rules against an ace or ten the values are conditional on the dealer not
+ * having blackjack. One analyzer belongs to one thread.
+ */
+class HandAnalyzer {
+public:
+    HandAnalyzer(const RuleSet& rules, int upcard);
+
+    /**
+     * @brief Expected value of every action on a hand.
+     * @param shoe The cards left to draw: the upcard and the hand must already be removed.
+     * @param ranks Rank indices of the hand's cards.
+     * @param count Number of cards in the hand, at least one.
+     * @param fromSplit True for a hand made by splitting, which cannot split or surrender,
+     *        and may only double under DAS.
+     */
+    ActionValues evaluate(const ShoeComposition& shoe, const int *ranks, int count, bool fromSplit = false);
+
+    /**
+     * @brief Expected value of a two-card starting hand played as well as possible.
+     *
+     * Includes the chance that the dealer has blackjack and the player's own blackjack, so
+     * the result is unconditional even when evaluate() is conditional on the peek.
+     */
+    double initialHandValue(const ShoeComposition& shoe, int first, int second);
+
+    /// Expected value of a round against this upcard, over every starting hand.
+    double upcardValue(const ShoeComposition& shoe);
+
+    int upcard() const { return dealerUpcard; }
+
+    /// Flag polled during a calculation; once it reads true, AnalysisCancelled is thrown.
+    void setCancelFlag(const std::atomic<bool> *flag) { cancelFlag = flag; }
+
+    /// Number of memoized player results.
+    std::size_t size() const { return memo.size(); }
+
+    /// Forgets every memoized result, player and dealer.
+    void clear() {
+        memo.clear();
+        dealer.clear();
+    }
+
+    /// Chance that the hole card gives the dealer blackjack.
+    double dealerBlackjackChance(const ShoeComposition& shoe) const;
+
+private:
+    double stand(ShoeComposition& shoe, int hardTotal, bool hasAce);
+    double hit(ShoeComposition& shoe, int hardTotal, bool hasAce);
+    double bestHitOrStand(ShoeComposition& shoe, int hardTotal, bool hasAce);
+    double doubleDown(ShoeComposition& shoe, int hardTotal, bool hasAce);
+    double splitHand(ShoeComposition& shoe, int pairRank);
+    void checkCancelled() const;
+
+    RuleSet rules;
+    int dealerUpcard;
+    bool peeked;                  /// Values are conditional on no dealer blackjack.
+    DealerProbabilities dealer;
+    const std::atomic<bool> *cancelFlag = nullptr;
+    std::unordered_map<CompositionKey, double, CompositionKeyHash> memo;
+};
+
+
+/**
+ * @struct AnalysisReport
+ * @brief Results of analysing a whole shoe.
+ */
+struct AnalysisReport {
+    ActionValues hands[RANKS][RANKS][RANKS]; /// [upcard][first][second], filled for first <= second.
+    double initialValue[RANKS][RANKS][RANKS] = {}; /// initialHandValue(), indexed like hands.
+    double upcardValue[RANKS] = {};          /// Expected value of a round against each upcard.
+    double expectedValue = 0.0;              /// Expected value of a round, per unit bet.
+};
+
+
+/**
+ * @brief Analyses every starting hand against every upcard.
+ * @param rules The table rules.
+ * @param shoe The shoe before the round is dealt.
+ * @param threads Worker threads; 0 uses one per hardware thread, up to one per upcard.
+ * @return The per-hand action values and the round's expected value.
+ */
+AnalysisReport analyzeShoe(const RuleSet& rules, const ShoeComposition& shoe, int threads = 0);
+
+
+#endif // ANALYZER_H
@@ -0,0 +1,152 @@
+#ifndef BETTING_H
+#define BETTING_H
+
+#include <cmath>
+#include <string>
+#include "headers/counting.h"
+#include "headers/stats.h"
+
+/**
+ * @file betting.h
+ * @brief Count-indexed bet ramps and per-count results.
+ *
+ * A BetRamp turns the true count before a round into a bet in units. BettingStats collects
+ * what each bet won, binned by the floored true count it was placed at. It is a plain
+ * struct with no locks or atomics: every simulation thread fills its own and the totals
+ * are merged once the threads are done.
+ */
+
+
+constexpr int COUNT_BIN_LOW = -5;  /// True counts at or below this share the lowest bin.
+constexpr int COUNT_BIN_HIGH = 10; /// True counts at or above this share the highest bin.
+constexpr int COUNT_BINS = COUNT_BIN_HIGH - COUNT_BIN_LOW + 1;
+
+
+/// Bin of a true count: floored, then clamped to the binned range.
+inline int countBin(double trueCount) {
+    int count = (int) std::floor(trueCount);
+    count = count < COUNT_BIN_LOW ? COUNT_BIN_LOW : (count > COUNT_BIN_HIGH ? COUNT_BIN_HIGH : count);
+    return count - COUNT_BIN_LOW;
+}
+
+/// Floored true count a bin stands for.
+constexpr int binCount(int bin) { return bin + COUNT_BIN_LOW; }
+
+
+/**
+ * @enum RampKind
+ * @brief How a BetRamp sizes bets.
+ */
+enum RampKind {
+    RAMP_FIXED,  /// step units per true count from the pivot up, between minBet and maxBet.
+    RAMP_KELLY,  /// A fraction of the Kelly bet for the edge the count implies.
+    RAMP_TABLE   /// A bet listed for each count bin.
+};
+
+
+/**
+ * @struct BetRamp
+ * @brief Bet size in units as a function of the true count.
+ *
+ * The default is a flat one-unit bet. bet(trueCount) sizes Kelly bets from a fixed
+ * bankroll, so the ramp does not change as a simulation goes on; bet(trueCount, balance)
+ * sizes them from a running balance. Kelly bets assume a Hi-Lo true count until
+ * setCountingSystem() says otherwise.
+ */
+struct BetRamp {
+    RampKind kind = RAMP_FIXED;
+    double minBet = 1.0;
+    double maxBet = 1.0;
+    double step = 1.0;             /// Fixed: units added per true count.
+    int pivot = 1;                 /// Fixed: the count at which the bet is step units.
+    double bankroll = 10000.0;     /// Kelly: bankroll the bets are sized from, in units.
+    double kellyFraction = 1.0;
+    double baseEdge = -0.005;      /// Kelly: player edge at a true count of zero.
+    double edgePerCount = 0.005;   /// Kelly: edge gained per true count, edgePerTrueCount() of the system.
+    double variance = 1.3;         /// Kelly: variance of one round per unit bet.
+    double tableBets[COUNT_BINS] = {};
+
+    double bet(double trueCount) const;
+
+    /// Sizes Kelly bets from the true count of this system. Returns false for a Kelly ramp
+    /// with an unbalanced system, whose count CardCounter does not divide into a true count.
+    bool setCountingSystem(CountingSystem system);
+
+    /// The bet for a player holding balance units; Kelly sizes from the balance instead.
+    double bet(double trueCount, double balance) const;
+
+    std::string describe() const;
+};
+
+
+/**
+ * @brief Parses a ramp from the command line.
+ *
+ * fixed:MIN:MAX[:STEP[:PIVOT]], kelly:BANKROLL[:FRACTION[:MIN[:MAX]]] or
+ * table:TC=BET,TC=BET,... where each listed bet holds from its count up to the next one
+ * listed, and counts below the lowest take the lowest's bet.
+ *
+ * @return True and sets ramp if the text is valid.
+ */
+bool parseBetRamp(const char *text, BetRamp& ramp);
+
+
+/**
+ * @brief Player edge gained per point of a balanced system's true count.
+ *
+ * The slope of a least-squares fit of typical effects of removal to the system's tags,
+ * scaled so Hi-Lo gets the usual half a percent. A level-two system's true count moves
+ * about twice as far for the same shoe, so each point is worth about half as much.
+ */
+double edgePerTrueCount(CountingSystem system);
+
+
+/**
+ * @struct BinStats
+ * @brief Statistics of the rounds played in one count bin.
+ */
+struct BinStats {
+    long rounds = 0;
+    double wagered = 0.0;      /// Total initial bets, in units.
+    RunningStats results;      /// Won per round, in units.
+    RunningStats unitResults;  /// Won per unit bet, so bins compare regardless of bet.
+
+    void add(double bet, double result) {
+        ++rounds;
+        wagered += bet;
+        results.add(result);
+        unitResults.add(bet > 0.0 ? result / bet : 0.0);
+    }
+
+    void merge(const BinStats& other);
+
+    double winRate() const { return results.mean(); }                          /// Units per round.
+    double standardDeviation() const { return results.standardDeviation(); }   /// Units per round.
+    double unitExpectation() const { return unitResults.mean(); }              /// Per unit bet.
+    double unitDeviation() const { return unitResults.standardDeviation(); }   /// Per unit bet.
+
+    /// Win rate per 100 rounds with optimal bets from a 10,000-unit bankroll: 10^6 (EV / SD)^2.
+    double score() const;
+
+    /// Rounds needed for the expected win to equal one standard deviation: (SD / EV)^2,
+    /// infinite when the expected win is not positive.
+    double n0() const;
+};
+
+
+/**
+ * @struct BettingStats
+ * @brief Results of a run, one BinStats per count bin.
+ */
+struct BettingStats {
+    BinStats bins[COUNT_BINS];
+
+    void add(double trueCount, double bet, double result) { bins[countBin(trueCount)].add(bet, result); }
+    void merge(const BettingStats& other);
+
+    /// Every bin combined.
+    BinStats total() const;
+};
+
+
+#endif // BETTING_H
@@ -0,0 +1,47 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+/**
+ * @file cache.h
+ * @brief A directory of finished results, keyed by what they were computed from.
+ *
+ * Exact calculations that take seconds per rule set are kept on disk so that asking again
+ * costs only a file read. Each result is one text file named after its kind and a 64-bit
+ * key, usually RuleSet::hash(), e.g. eor-1f3a...txt. Files are written to a temporary name
+ * and renamed into place, so a reader never sees half a result.
+ */
+
+
+/**
+ * @class ResultCache
+ * @brief Loads and stores result files in one directory.
+ */
+class ResultCache {
+public:
+    /// @param directory Created when the first result is stored.
+    explicit ResultCache(std::string directory) : root(std::move(directory)) {}
+
+    /// BJ_CACHE_DIR if it is set, otherwise .bjsim-cache in the working directory.
+    static std::string defaultDirectory();
+
+    /// Reads a stored result; returns false if there is none.
+    bool load(const char *kind, std::uint64_t key, std::string& contents) const;
+
+    /// Stores a result, replacing any earlier one; returns false if it could not be written.
+    bool store(const char *kind, std::uint64_t key, const std::string& contents) const;
+
+    /// File a result is kept in.
+    std::string path(const char *kind, std::uint64_t key) const;
+
+    const std::string& directory() const { return root; }
+
+private:
+    std::string root;
+};
+
+
+#endif // CACHE_H
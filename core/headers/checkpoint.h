@@ -0,0 +1,154 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file checkpoint.h
+ * @brief Binary snapshots of a long run's state, kept on disk so the run can resume.
+ *
+ * SnapshotWriter and SnapshotReader copy plain values to and from a byte string as they lie
+ * in memory, which is as fast as a snapshot can be but only meant to be read back by the
+ * same build. A run that can be checkpointed is split into independent streams, one per
+ * thread. Each stream saves its state at its own pace, and CheckpointFile writes every
+ * stream's latest state to one file, atomically, so a run killed at any moment leaves
+ * either the previous checkpoint or the new one. On restart each stream picks up exactly
+ * where its saved state left off, which makes the resumed run's results identical bit for
+ * bit to one that was never interrupted.
+ */
+
+
+/**
+ * @class SnapshotWriter
+ * @brief Appends values to a binary snapshot.
+ */
+class SnapshotWriter {
+public:
+    template <class T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshots hold plain values only");
+        putBytes(&value, sizeof value);
+    }
+
+    void putBytes(const void *data, std::size_t size) { bytes.append(static_cast<const char *>(data), size); }
+
+    /// A length followed by the characters.
+    void putString(const std::string& text) {
+        put<std::uint64_t>(text.size());
+        bytes += text;
+    }
+
+    const std::string& data() const { return bytes; }
+
+private:
+    std::string bytes;
+};
+
+
+/**
+ * @class SnapshotReader
+ * @brief Reads values back in the order they were written.
+ *
+ * Every read returns false, and leaves the value alone, once the snapshot runs out.
+ */
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const std::string& bytes) : bytes(bytes) {}
+
+    template <class T>
+    bool get(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshots hold plain values only");
+        return getBytes(&value, sizeof value);
+    }
+
+    bool getBytes(void *data, std::size_t size) {
+        if (bytes.size() - offset < size) {
+            offset = bytes.size();
+            return false;
+        }
+        std::memcpy(data, bytes.data() + offset, size);
+        offset += size;
+        return true;
+    }
+
+    bool getString(std::string& text) {
+        std::uint64_t size = 0;
+        if (!get(size) || bytes.size() - offset < size) {
+            offset = bytes.size();
+            return false;
+        }
+        text.assign(bytes, offset, size);
+        offset += size;
+        return true;
+    }
+
+    /// True once every byte has been read.
+    bool atEnd() const { return offset == bytes.size(); }
+
+private:
+    const std::string& bytes;
+    std::size_t offset = 0;
+};
+
+
+/**
+ * @class CheckpointFile
+ * @brief The saved state of every stream of one run, shared by the threads running them.
+ *
+ * The file starts with a fingerprint of everything the run's results depend on; a file
+ * from a different run is not resumed.
+ */
+class CheckpointFile {
+public:
+    /**
+     * @param path File to keep the checkpoint in.
+     * @param fingerprint Identifies the run, e.g. a hash of its options.
+     * @param streams Number of independent streams.
+     * @param interval Time between one stream's saves.
+     */
+    CheckpointFile(std::string path, std::uint64_t fingerprint, int streams, std::chrono::milliseconds interval);
+
+    /**
+     * @brief Reads the states saved by an earlier attempt at the same run.
+     * @return True if there is a checkpoint for this run; false if there is none, or it is
+     *         unreadable or for a different run, in which case the run starts afresh.
+     */
+    bool load();
+
+    /// A stream's saved state, or nullptr if it has none.
+    const std::string *state(int stream) const;
+
+    /// True once the stream's last save is an interval old; cheap enough to ask often.
+    bool due(int stream) const { return std::chrono::steady_clock::now() >= next[stream]; }
+
+    /**
+     * @brief Replaces a stream's state and writes the checkpoint.
+     * @return False if the file could not be written; the run can carry on regardless.
+     */
+    bool save(int stream, std::string state);
+
+    /// Deletes the checkpoint once the run is complete.
+    void remove();
+
+    const std::string& path() const { return file; }
+
+private:
+    bool write() const;
+
+    std::string file;
+    std::uint64_t fingerprint;
+    std::chrono::milliseconds interval;
+    std::vector<std::string> states;
+    std::vector<bool> saved;
+    std::vector<std::chrono::steady_clock::time_point> next;
+    std::mutex mutex;
+};
+
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,95 @@
+#ifndef COMPOSITION_H
+#define COMPOSITION_H
+
+#include <cstddef>
+#include <cstdint>
+#include "headers/DeckSetup.h"
+
+/**
+ * @file composition.h
+ * @brief The cards left in a shoe, counted by blackjack rank.
+ *
+ * Exact calculations only care how many cards of each rank are left, not their order or
+ * suit, so a shoe reduces to ten counts: ace, two to nine, and the ten-valued cards
+ * together. Working on counts instead of cards is what lets the calculators share results
+ * between every shoe with the same contents.
+ */
+
+
+constexpr int RANKS = 10; /// Ace, 2 to 9, and ten-valued cards.
+
+
+/// Rank index of a card: 0 for an ace, value - 1 otherwise, so tens and faces share 9.
+inline int rankIndex(const Card& card) { return card.value - 1; }
+
+/// Blackjack value of a rank index, with an ace as 1.
+constexpr int rankValue(int rank) { return rank + 1; }
+
+
+/**
+ * @struct ShoeComposition
+ * @brief Number of cards of each rank left in a shoe.
+ */
+struct ShoeComposition {
+    int counts[RANKS] = {};
+    int total = 0;
+
+    /// A full shoe of the given number of decks.
+    static ShoeComposition fullShoe(int decks);
+
+    /// The cards still to be dealt from a shoe.
+    static ShoeComposition remainingIn(const MultiDeck& shoe);
+
+    void remove(int rank) { --counts[rank]; --total; }
+    void add(int rank) { ++counts[rank]; ++total; }
+
+    /// Chance that the next card is of the given rank.
+    double probability(int rank) const { return total > 0 ? double(counts[rank]) / total : 0.0; }
+
+    /**
+     * @brief Packs the counts into one exact 64-bit key.
+     *
+     * Ranks 0 to 8 take six bits each and tens the top eight, which holds any shoe of up to
+     * eight decks; two compositions have the same key only if they are equal.
+     */
+    std::uint64_t key() const {
+        std::uint64_t packed = 0;
+        for (int rank = 0; rank < RANKS - 1; ++rank) {
+            packed |= std::uint64_t(counts[rank]) << (6 * rank);
+        }
+        return packed | std::uint64_t(counts[RANKS - 1]) << 54;
+    }
+
+    bool operator==(const ShoeComposition& other) const { return key() == other.key(); }
+};
+
+
+/**
+ * @struct CompositionKey
+ * @brief Memo key for a result that depends on a composition plus a little hand state.
+ */
+struct CompositionKey {
+    std::uint64_t shoe;   /// ShoeComposition::key().
+    std::uint32_t state;  /// Whatever else the result depends on, packed by the caller.
+
+    bool operator==(const CompositionKey& other) const { return shoe == other.shoe && state == other.state; }
+};
+
+/**
+ * @brief Hash for CompositionKey in unordered containers.
+ *
+ * Drawing a card moves one rank count and the hand total by related amounts, so the shoe
+ * and state are combined by multiplication and then fully mixed rather than XORed, which
+ * would make neighbouring keys collide.
+ */
+struct CompositionKeyHash {
+    std::size_t operator()(const CompositionKey& key) const {
+        std::uint64_t mixed = key.shoe * 0x9E3779B97F4A7C15ULL + key.state;
+        mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+        return std::size_t(mixed ^ (mixed >> 31));
+    }
+};
+
+
+#endif // COMPOSITION_H
@@ -0,0 +1,174 @@
+#ifndef COUNTING_H
+#define COUNTING_H
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @file counting.h
+ * @brief Running and true counts for several card counting systems at once.
+ *
+ * Each system is a constexpr row of tags, one per card value. The rows are transposed at
+ * compile time into one row of lanes per card value, padded to a vector width, so a card
+ * updates every system with a single fixed-length add the compiler turns into vector
+ * instructions. MultiDeck keeps a CardCounter and feeds it every card it deals.
+ */
+
+
+/**
+ * @enum CountingSystem
+ * @brief The counting systems CardCounter keeps.
+ */
+enum CountingSystem {
+    COUNT_HI_LO,
+    COUNT_KO,        /// Unbalanced: the running count starts below zero and is used as is.
+    COUNT_HI_OPT_II,
+    COUNT_OMEGA_II,
+    COUNT_ZEN,
+    COUNT_SYSTEMS
+};
+
+
+constexpr int TAGGED_VALUES = 10; /// Card values 1 (ace) to 10, tagged at index value - 1.
+constexpr int COUNT_LANES = 8;    /// COUNT_SYSTEMS rounded up to a vector width.
+
+
+/**
+ * @struct CountingTags
+ * @brief How one system values each card.
+ */
+struct CountingTags {
+    const char *name;
+    const char *option;              /// Name on the command line.
+    signed char tags[TAGGED_VALUES]; /// Ace, 2 to 9, then ten-valued cards.
+};
+
+
+constexpr CountingTags COUNTING_TAGS[COUNT_SYSTEMS] = {
+    //                           A   2   3   4   5   6   7   8   9   T
+    { "Hi-Lo",     "hilo",    { -1, +1, +1, +1, +1, +1,  0,  0,  0, -1 } },
+    { "KO",        "ko",      { -1, +1, +1, +1, +1, +1, +1,  0,  0, -1 } },
+    { "Hi-Opt II", "hiopt2",  {  0, +1, +1, +2, +2, +1, +1,  0,  0, -2 } },
+    { "Omega II",  "omega2",  {  0, +1, +1, +2, +2, +2, +1,  0, -1, -2 } },
+    { "Zen",       "zen",     { -1, +1, +1, +2, +2, +2, +1,  0,  0, -2 } },
+};
+
+
+/// Sum of a system's tags over one 52-card deck; zero for a balanced system.
+constexpr int deckTagSum(CountingSystem system) {
+    int sum = 0;
+    for (int value = 0; value < TAGGED_VALUES; ++value) {
+        sum += COUNTING_TAGS[system].tags[value] * (value == TAGGED_VALUES - 1 ? 16 : 4);
+    }
+    return sum;
+}
+
+static_assert(deckTagSum(COUNT_HI_LO) == 0, "Hi-Lo is balanced");
+static_assert(deckTagSum(COUNT_KO) == 4, "KO gains four per deck");
+static_assert(deckTagSum(COUNT_HI_OPT_II) == 0, "Hi-Opt II is balanced");
+static_assert(deckTagSum(COUNT_OMEGA_II) == 0, "Omega II is balanced");
+static_assert(deckTagSum(COUNT_ZEN) == 0, "Zen is balanced");
+
+
+/**
+ * @brief Looks up a system by its command-line name, e.g. "hilo".
+ * @return True and sets system if the name is known.
+ */
+inline bool parseCountingSystem(const char *option, CountingSystem& system) {
+    for (int index = 0; index < COUNT_SYSTEMS; ++index) {
+        if (std::strcmp(option, COUNTING_TAGS[index].option) == 0) {
+            system = CountingSystem(index);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @struct CountingLanes
+ * @brief COUNTING_TAGS transposed: for each card value, the tag of every system.
+ */
+struct CountingLanes {
+    std::int32_t lanes[TAGGED_VALUES][COUNT_LANES] = {};
+};
+
+constexpr CountingLanes countingLanes() {
+    CountingLanes table;
+    for (int value = 0; value < TAGGED_VALUES; ++value) {
+        for (int system = 0; system < COUNT_SYSTEMS; ++system) {
+            table.lanes[value][system] = COUNTING_TAGS[system].tags[value];
+        }
+    }
+    return table;
+}
+
+constexpr CountingLanes COUNTING_LANES = countingLanes();
+
+
+/**
+ * @class CardCounter
+ * @brief Running count of every system over the cards seen since the last shuffle.
+ */
+class CardCounter {
+public:
+    explicit CardCounter(int decks = 6) { reset(decks); }
+
+    /// Starts a fresh shoe: balanced counts at zero, KO at its initial running count.
+    void reset(int decks) {
+        deckCount = decks;
+        seen = 0;
+        for (int system = 0; system < COUNT_LANES; ++system) {
+            running[system] = system < COUNT_SYSTEMS ? -deckTagSum(CountingSystem(system)) * (decks - 1) : 0;
+        }
+    }
+
+    /// Counts a card, given its blackjack value with an ace as 1.
+    void observe(int value) {
+        const std::int32_t *tags = COUNTING_LANES.lanes[value - 1];
+        for (int lane = 0; lane < COUNT_LANES; ++lane) {
+            running[lane] += tags[lane];
+        }
+        ++seen;
+    }
+
+    /// Takes a card dealt face down back out of the count; observe() it once it is turned up.
+    void forget(int value) {
+        const std::int32_t *tags = COUNTING_LANES.lanes[value - 1];
+        for (int lane = 0; lane < COUNT_LANES; ++lane) {
+            running[lane] -= tags[lane];
+        }
+        --seen;
+    }
+
+    int runningCount(CountingSystem system) const { return running[system]; }
+
+    /// Decks not yet seen, from the exact number of cards seen.
+    double decksRemaining() const { return (deckCount * 52 - seen) / 52.0; }
+
+    /**
+     * @brief Running count per deck remaining.
+     *
+     * KO is designed to be played off its running count, so for KO this is the running
+     * count itself. With no cards left it is the running count too.
+     */
+    double trueCount(CountingSystem system) const {
+        double decks = decksRemaining();
+        if (deckTagSum(system) != 0 || decks <= 0.0) {
+            return running[system];
+        }
+        return running[system] / decks;
+    }
+
+    int cardsSeen() const { return seen; }
+
+    static const char *systemName(CountingSystem system) { return COUNTING_TAGS[system].name; }
+
+private:
+    alignas(32) std::int32_t running[COUNT_LANES];
+    int deckCount;
+    int seen;
+};
+
+
+#endif // COUNTING_H
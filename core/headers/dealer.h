@@ -14,6 +14,7 @@
 #define GROUP13_DEALER_H
 #include "headers/DeckSetup.h"
 #include "headers/player.h"
+#include "headers/handvalue.h"
 
 
 
@@ -44,10 +45,13 @@ public:
 
     std::pair<int, int> CheckHand();
 
-    QString PlayHand();
-    int CompareHands(player& p);
-    QString GetHandString();
-    QString GetHandString_oneCard();
+    HandValue PlayHand(bool hitSoft17 = false);
+    HandOutcome CompareHands(const Hand& playerHand);
+    HandValue GetHandValue() const;
+    int GetUpcardValue() const;
+
+    /// True if the hand is a two-card 21.
+    bool HasBlackjack() const { return hand.size() == 2 && GetHandValue().total == 21; }
 
 
 };
@@ -0,0 +1,94 @@
+#ifndef DEALERPROB_H
+#define DEALERPROB_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "headers/composition.h"
+
+/**
+ * @file dealerprob.h
+ * @brief Exact dealer outcome probabilities for a given shoe composition.
+ *
+ * DealerProbabilities enumerates every way the dealer can draw from a ShoeComposition,
+ * following the same drawing rule as dealer::PlayHand, and returns the chance of each final
+ * total. For each upcard it lists, once, every set of cards the dealer can finish with and
+ * the number of orders they can be drawn in. The chance of any one order depends only on
+ * the rank counts, so the outcome for a new composition is a flat sum over that list with
+ * no recursion or lookups, and it is then cached on the exact rank counts.
+ */
+
+
+/**
+ * @enum DealerResult
+ * @brief How the dealer's hand can finish.
+ */
+enum DealerResult {
+    DEALER_17, DEALER_18, DEALER_19, DEALER_20, DEALER_21,
+    DEALER_BUST,
+    DEALER_BLACKJACK, /// A two-card 21; never reported when the dealer has already peeked.
+    DEALER_RESULTS
+};
+
+
+/**
+ * @struct DealerOutcome
+ * @brief Probability of each DealerResult; the entries sum to one.
+ */
+struct DealerOutcome {
+    double probability[DEALER_RESULTS] = {};
+};
+
+
+/**
+ * @class DealerProbabilities
+ * @brief Memoized calculator of dealer final-total distributions.
+ *
+ * The cache is not shared between threads: give each thread its own calculator.
+ */
+class DealerProbabilities {
+public:
+    /// @param hitSoft17 True for H17 tables, false for S17.
+    explicit DealerProbabilities(bool hitSoft17) : hitSoft17(hitSoft17) {}
+
+    /**
+     * @brief Distribution of the dealer's final hand.
+     * @param shoe The unseen cards the hole card and any draws come from; the upcard and
+     *        any other cards already seen must be removed from it.
+     * @param upcard Rank index of the dealer's upcard.
+     * @param peeked True if the dealer has checked and does not have blackjack.
+     * @return The probabilities, valid until the next call that adds to the cache. Draws the
+     *         shoe cannot supply are left out, so near the end of a shoe they may sum to
+     *         less than one.
+     * @throws std::out_of_range if there is no card left for the hole card.
+     */
+    const DealerOutcome& outcome(const ShoeComposition& shoe, int upcard, bool peeked);
+
+    bool hitsSoft17() const { return hitSoft17; }
+
+    /// Number of memoized results.
+    std::size_t size() const { return cache.size(); }
+
+    /// Forgets every memoized result.
+    void clear() { cache.clear(); }
+
+private:
+    /// A set of cards the dealer can finish with, hole card included, as its distinct ranks.
+    struct DrawnCards {
+        unsigned char ranks[RANKS];
+        unsigned char taken[RANKS]; /// How many of each of ranks were drawn.
+        unsigned char distinct;
+        unsigned char cards;
+        unsigned char result;       /// The DealerResult these cards end in.
+        double orderings;           /// Number of orders the dealer can draw them in.
+    };
+
+    const std::vector<DrawnCards>& drawsFor(int upcard);
+
+    bool hitSoft17;
+    std::vector<DrawnCards> draws[RANKS];   /// Built on first use of each upcard.
+    std::unordered_map<CompositionKey, DealerOutcome, CompositionKeyHash> cache;
+};
+
+
+#endif // DEALERPROB_H
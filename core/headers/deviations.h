@@ -0,0 +1,84 @@
+#ifndef DEVIATIONS_H
+#define DEVIATIONS_H
+
+#include <string>
+#include <vector>
+#include "headers/counting.h"
+#include "headers/engine.h"
+
+/**
+ * @file deviations.h
+ * @brief Count-based departures from basic strategy and the file they are kept in.
+ *
+ * An IndexTable lists, for one counting system, the plays that change with the true count
+ * and the index at which each one changes, plus the insurance index. bjsim indices writes
+ * one; IndexStrategy plays by it, and the GUI's moves chart lists it next to the chart.
+ *
+ * The file is plain text, one entry per line, with '#' starting a comment:
+ *
+ *     count hilo
+ *     insurance 3.0
+ *     play hard16 10 stand >= 0.0
+ *     play hard12 4 hit <= 0.0
+ *
+ * A play names its row (hard5 to hard21, soft13 to soft21, or pair2 to pair11 with an ace
+ * as 11), the dealer's upcard (2 to 11), the action taken instead of basic strategy, and
+ * whether it is taken at or above, or at or below, the index.
+ */
+
+
+/**
+ * @struct Deviation
+ * @brief A play that replaces basic strategy on one side of a true count.
+ */
+struct Deviation {
+    int row;          /// StrategyTable row: hardRow(), softRow() or pairRow().
+    int upcard;       /// Dealer upcard, 2 to 11.
+    Action action;
+    double index;
+    bool atOrAbove;   /// Taken at true counts of index and up; otherwise index and down.
+
+    bool applies(double trueCount) const { return atOrAbove ? trueCount >= index : trueCount <= index; }
+};
+
+
+/**
+ * @struct IndexTable
+ * @brief Deviation indices and the insurance index for one counting system.
+ */
+struct IndexTable {
+    CountingSystem system = COUNT_HI_LO;
+    bool insures = false;         /// Whether an insurance index is given.
+    double insuranceIndex = 3.0;
+    std::vector<Deviation> plays;
+
+    /// Reads a table file; returns false, leaving the table unchanged, if it cannot be read
+    /// or has a line it does not understand.
+    bool load(const std::string& path);
+
+    /// Writes the table, replacing the file only once it is complete.
+    /// @param comment Written first as '#' lines, e.g. the rules it was made for.
+    bool save(const std::string& path, const std::string& comment = std::string()) const;
+
+    /// The table as file text.
+    std::string format() const;
+
+    /// The deviation for a row and upcard, or nullptr if basic strategy stands.
+    const Deviation *find(int row, int upcard) const;
+};
+
+
+/// Name of a strategy row as used in table files, e.g. "hard16" or "pair10".
+std::string strategyRowName(int row);
+
+/// Reads a strategy row name; returns false if it is not one.
+bool parseStrategyRow(const char *name, int& row);
+
+/// Name of an action as used in table files, e.g. "stand".
+const char *actionName(Action action);
+
+/// Reads an action name; returns false if it is not one.
+bool parseAction(const char *name, Action& action);
+
+
+#endif // DEVIATIONS_H
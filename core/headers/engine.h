@@ -0,0 +1,439 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "headers/DeckSetup.h"
+#include "headers/hand.h"
+#include "headers/handvalue.h"
+#include "headers/player.h"
+#include "headers/rules.h"
+#include "headers/table.h"
+#include "headers/trace.h"
+
+/**
+ * @file engine.h
+ * @brief Headless round engine, specialised on a rules policy.
+ *
+ * Engine plays complete rounds against a shoe without any UI. It is a template on a rules
+ * policy from rules.h, so with a StaticRules policy every rule check in the round loop is a
+ * compile-time constant. Seats live in a Table, each a player whose split hands sit in one
+ * fixed array, and results are returned as plain numbers, so playing a round never allocates
+ * or formats text.
+ */
+
+
+/**
+ * @enum Action
+ * @brief A playing decision.
+ */
+enum Action { ACTION_STAND, ACTION_HIT, ACTION_DOUBLE, ACTION_SPLIT, ACTION_SURRENDER };
+
+constexpr int ACTION_KINDS = ACTION_SURRENDER + 1;
+constexpr int NO_ACTION = -1; /// Opening action of a seat that had no decision to make.
+
+
+/**
+ * @struct HandState
+ * @brief What a strategy is told about the hand it has to play.
+ */
+struct HandState {
+    HandValue value;
+    int cardCount;
+    int dealerUpcard;   /// 2 to 11, with an ace counted as 11.
+    int pairValue;      /// Value of each card of a pair, ace as 11; 0 if the hand is not a pair.
+    bool fromSplit;
+    bool canDouble;
+    bool canSplit;
+    bool canSurrender;
+    double trueCount;   /// The engine's counting system, with the hole card not yet seen.
+};
+
+
+/**
+ * @struct MimicDealerStrategy
+ * @brief Plays like the dealer: hit below 17, otherwise stand, and never insure.
+ */
+struct MimicDealerStrategy {
+    Action decide(const HandState& state) const {
+        return state.value.total < 17 ? ACTION_HIT : ACTION_STAND;
+    }
+
+    bool takeInsurance(const HandState&) const { return false; }
+};
+
+
+/// Blackjack value of a card as an upcard, counting an ace as 11.
+inline int upcardValue(const Card& card) {
+    return card.name == ACE ? 11 : card.value;
+}
+
+
+/**
+ * @class Engine
+ * @brief Plays rounds for a table of seats against the dealer under a rules policy.
+ *
+ * The dealer's first card is the hole card and the second the upcard, matching dealer and
+ * GameUI. Cards are dealt in table order: one to each seat, the hole card, a second to each
+ * seat, then the upcard. Results are the table's net win or loss in betting units.
+ */
+template <class Rules>
+class Engine {
+public:
+    Engine(const Rules& rules, MultiDeck& shoe, int seats = 1) : rules(rules), shoe(shoe), table(&shoe, seats) {
+        shoe.setDeckCount(rules.decks());
+    }
+
+    int seatCount() const { return table.seatCount; }
+
+    /// Chooses the system whose true count strategies see; Hi-Lo by default.
+    void setCountingSystem(CountingSystem system) { countingSystem = system; }
+
+    /// True count of the cards seen so far, for sizing the next bet between rounds.
+    double trueCount() const { return shoe.counts.trueCount(countingSystem); }
+
+    const Rules& ruleSet() const { return rules; }
+
+    /// Net result of a seat in the last round, in betting units.
+    double seatResult(int seat) const { return seatNet[seat]; }
+
+    /// First action a seat took in the last round, or NO_ACTION if it had none to take.
+    int openingAction(int seat) const { return opening[seat]; }
+
+    /// The two cards a seat was dealt in the last round, before any split or draw.
+    const Card *dealtCards(int seat) const { return dealt[seat]; }
+
+    /// The dealer's upcard in the last round.
+    const Card& dealerUpcard() const { return house.cards[1]; }
+
+    /// True if the dealer must draw to this hand.
+    bool dealerHits(const HandValue& value) const {
+        return value.total < 17 || (rules.hitSoft17() && value.soft && value.total == 17);
+    }
+
+    /// Draws dealer cards until the dealer stands or busts.
+    void playDealer(Hand& hand) {
+        TRACE_SCOPE("dealerPlay");
+        while (dealerHits(hand.value())) {
+            hand.add(draw());
+        }
+    }
+
+    /// Reshuffles once the cut card is reached; returns true if it did.
+    bool shuffleIfNeeded() {
+        if (shoe.needsShuffle(rules.penetration())) {
+            shoe.createAndShuffleDecks();
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Net result of a finished hand against the dealer's final hand.
+     * @param hand The player's hand, fully played.
+     * @param dealerHand The dealer's hand, fully played.
+     * @return Amount won (positive) or lost (negative) in betting units.
+     */
+    double settle(const Hand& hand, const Hand& dealerHand) const {
+        TRACE_SCOPE("settle");
+        if (hand.surrendered) {
+            return -0.5 * hand.bet;
+        }
+        bool playerNatural = hand.isNatural();
+        bool dealerNatural = dealerHand.isNatural();
+        if (playerNatural || dealerNatural) {
+            if (playerNatural && dealerNatural) {
+                return 0.0;
+            }
+            return playerNatural ? rules.blackjackPayout() * hand.bet : -hand.bet;
+        }
+        switch (compareHandValues(dealerHand.value(), hand.value())) {
+        case OUTCOME_WIN: return hand.bet;
+        case OUTCOME_LOSE: return -hand.bet;
+        default: return 0.0;
+        }
+    }
+
+    /**
+     * @brief Plays one complete round for every seat at the table.
+     *
+     * Against an ace each seat is offered insurance, or even money when it holds a
+     * blackjack. Under peek rules a dealer blackjack then ends the round before any
+     * decision or draw.
+     *
+     * The hole card is kept out of the shoe's counts until the seats have played, so
+     * strategies only see the count of cards a player could have seen.
+     *
+     * @param strategy Object with Action decide(const HandState&) and
+     *        bool takeInsurance(const HandState&) members, used for every seat.
+     * @param bet Initial bet of every seat, in betting units.
+     * @return The table's net result in betting units, summed over every hand the seats
+     *         split into, including any insurance.
+     */
+    template <class Strategy>
+    double playRound(Strategy& strategy, double bet = 1.0) {
+        shuffleIfNeeded();
+        table.resetHands();
+        house.clear();
+        for (int index = 0; index < table.seatCount; ++index) {
+            table.seats[index].hands[0].bet = bet;
+            seatNet[index] = 0.0;
+            opening[index] = NO_ACTION;
+        }
+
+        for (int index = 0; index < table.seatCount; ++index) {
+            table.seats[index].hands[0].add(draw());
+        }
+        house.add(draw());
+        hideHoleCard();
+        for (int index = 0; index < table.seatCount; ++index) {
+            table.seats[index].hands[0].add(draw());
+            dealt[index][0] = table.seats[index].hands[0].cards[0];
+            dealt[index][1] = table.seats[index].hands[0].cards[1];
+        }
+        house.add(draw());
+
+        int upcard = upcardValue(house.cards[1]);
+        bool dealerNatural = house.isNatural();
+        bool peeked = dealerNatural && rules.dealerPeek();
+
+        // Decisions taken before the dealer checks for blackjack; a seat that surrenders
+        // early or takes even money is settled there and then.
+        bool settled[MAX_SEATS] = {};
+        for (int index = 0; index < table.seatCount; ++index) {
+            player& seat = table.seats[index];
+            Hand& first = seat.hands[0];
+            if (rules.surrender() == SURRENDER_EARLY && !first.isNatural()
+                && strategy.decide(stateOf(seat, first, upcard)) == ACTION_SURRENDER) {
+                first.surrendered = true;
+                opening[index] = ACTION_SURRENDER;
+                seatNet[index] += settle(first, house);
+                settled[index] = true;
+            } else if (upcard == 11 && strategy.takeInsurance(stateOf(seat, first, upcard))) {
+                if (first.isNatural()) {
+                    seatNet[index] += first.bet; // even money
+                    settled[index] = true;
+                } else {
+                    seat.insured = true;
+                    seatNet[index] += dealerNatural ? first.bet : -0.5 * first.bet; // half-bet side wager paying 2:1
+                }
+            }
+        }
+
+        // A peeked dealer blackjack leaves nothing to play. Without a peek the seats play on
+        // and lose to it at settlement. Split hands are appended to a seat, so handCount can
+        // grow while a seat plays.
+        bool anyLive = false;
+        for (int index = 0; index < table.seatCount; ++index) {
+            player& seat = table.seats[index];
+            if (settled[index] || peeked || seat.hands[0].isNatural()) {
+                continue;
+            }
+            for (int hand = 0; hand < seat.handCount; ++hand) {
+                seat.activeHand = hand;
+                playHand(strategy, seat, seat.hands[hand], upcard, opening[index]);
+                anyLive = anyLive || (!seat.hands[hand].surrendered && !seat.hands[hand].value().bust);
+            }
+        }
+
+        showHoleCard();
+        if (anyLive && !dealerNatural) {
+            playDealer(house);
+        }
+        double net = 0.0;
+        for (int index = 0; index < table.seatCount; ++index) {
+            for (int hand = 0; !settled[index] && hand < table.seats[index].handCount; ++hand) {
+                seatNet[index] += settle(table.seats[index].hands[hand], house);
+            }
+            net += seatNet[index];
+        }
+        return net;
+    }
+
+    /**
+     * @brief Plays one seat's hand from a chosen first action, for studying one decision.
+     *
+     * The seat's two cards and the dealer's upcard are given and must already be out of
+     * the shoe; the hole card and every later card are drawn from it. After the first
+     * action the hand is played on by the strategy. Nothing is shuffled, and there is no
+     * insurance or early surrender. Under peek rules a dealer blackjack settles the hand
+     * before the first action, so it then gives the same result for every action.
+     *
+     * @param strategy Plays the hand after the first action, and any split hands.
+     * @param cards The seat's two cards.
+     * @param upcard The dealer's upcard.
+     * @param first The first action; it must be available to the hand.
+     * @return The seat's net result in units of its initial bet.
+     */
+    template <class Strategy>
+    double playDecision(Strategy& strategy, const Card *cards, const Card& upcard, Action first) {
+        table.resetHands();
+        house.clear();
+        player& seat = table.seats[0];
+        Hand& hand = seat.hands[0];
+        hand.bet = 1.0;
+        hand.add(cards[0]);
+        hand.add(cards[1]);
+        house.add(draw());
+        hideHoleCard();
+        house.add(upcard);
+        int upcardRank = upcardValue(upcard);
+        if (house.isNatural() && rules.dealerPeek()) {
+            showHoleCard();
+            return settle(hand, house);
+        }
+
+        int opened = first;
+        seat.activeHand = 0;
+        if (first == ACTION_SURRENDER) {
+            hand.surrendered = true;
+        } else if (first == ACTION_DOUBLE) {
+            doubleDown(seat);
+        } else if (first == ACTION_SPLIT) {
+            split(seat);
+            playHand(strategy, seat, hand, upcardRank, opened);
+        } else if (first == ACTION_HIT) {
+            hand.add(draw());
+            playHand(strategy, seat, hand, upcardRank, opened);
+        }
+        for (int index = 1; index < seat.handCount; ++index) {
+            seat.activeHand = index;
+            playHand(strategy, seat, seat.hands[index], upcardRank, opened);
+        }
+
+        bool anyLive = false;
+        for (int index = 0; index < seat.handCount; ++index) {
+            anyLive = anyLive || (!seat.hands[index].surrendered && !seat.hands[index].value().bust);
+        }
+        showHoleCard();
+        if (anyLive && !house.isNatural()) {
+            playDealer(house);
+        }
+        double net = 0.0;
+        for (int index = 0; index < seat.handCount; ++index) {
+            net += settle(seat.hands[index], house);
+        }
+        return net;
+    }
+
+private:
+    /// Deals the next card. A round that runs a shallow shoe dry, such as a single deck dealt
+    /// deep to a full table, reshuffles the discards and carries on instead of failing. The
+    /// cards on the table stay out of the new shoe and count as seen in it, except a hole
+    /// card still face down, which is counted when it is turned up as usual.
+    Card draw() {
+        if (shoe.remaining() == 0) {
+            std::vector<Card> inPlay(house.cards, house.cards + house.count);
+            for (int index = 0; index < table.seatCount; ++index) {
+                const player& seat = table.seats[index];
+                for (int hand = 0; hand < seat.handCount; ++hand) {
+                    const Hand& cards = seat.hands[hand];
+                    inPlay.insert(inPlay.end(), cards.cards, cards.cards + cards.count);
+                }
+            }
+            shoe.shuffleDiscards(inPlay);
+            if (holeHidden) {
+                shoe.counts.forget(house.cards[0].value);
+            }
+        }
+        return shoe.drawCard();
+    }
+
+    /// Takes the dealer's first card back out of the count until it is turned up.
+    void hideHoleCard() {
+        shoe.counts.forget(house.cards[0].value);
+        holeHidden = true;
+    }
+
+    void showHoleCard() {
+        shoe.counts.observe(house.cards[0].value);
+        holeHidden = false;
+    }
+
+    /// Splits the seat's active pair and deals each of the two hands its second card.
+    void split(player& seat) {
+        Hand& added = seat.SplitPair();
+        seat.CurrentHand().add(draw());
+        added.add(draw());
+    }
+
+    /// Doubles the seat's active hand and deals its one card.
+    void doubleDown(player& seat) {
+        seat.DoubleBet();
+        seat.CurrentHand().add(draw());
+    }
+
+    /// True while a split ace hand may only stand, or split again if resplitting is allowed.
+    bool drawsOneCard(const Hand& hand) const {
+        return hand.isSplitAces() && !rules.hitSplitAces();
+    }
+
+    HandState stateOf(const player& seat, const Hand& hand, int upcard) const {
+        bool firstDecision = hand.count == 2;
+        HandState state;
+        state.value = hand.value();
+        state.cardCount = hand.count;
+        state.dealerUpcard = upcard;
+        state.pairValue = hand.isPair() ? upcardValue(hand.cards[0]) : 0;
+        state.fromSplit = hand.fromSplit;
+        state.canDouble = firstDecision && !drawsOneCard(hand) && (!hand.fromSplit || rules.doubleAfterSplit());
+        state.canSplit = firstDecision && seat.CanSplit(rules.maxSplitHands(), rules.resplitAces());
+        state.canSurrender = firstDecision && !hand.fromSplit && rules.surrender() != SURRENDER_NONE;
+        state.trueCount = shoe.counts.trueCount(countingSystem);
+        return state;
+    }
+
+    /**
+     * @brief Plays the seat's active hand; hand must be seat.CurrentHand().
+     * @param opening The seat's opening action, set to the first action taken if it is
+     *        still NO_ACTION.
+     */
+    template <class Strategy>
+    void playHand(Strategy& strategy, player& seat, Hand& hand, int upcard, int& opening) {
+        while (!hand.value().bust && hand.value().total < 21) {
+            HandState state = stateOf(seat, hand, upcard);
+            Action action = strategy.decide(state);
+            if (action == ACTION_SPLIT && state.canSplit) {
+                opening = opening == NO_ACTION ? ACTION_SPLIT : opening;
+                split(seat); // hand keeps its slot and gets a fresh second card
+                continue;
+            }
+            if (drawsOneCard(hand)) {
+                return;
+            }
+            if (action == ACTION_SURRENDER && state.canSurrender) {
+                action = ACTION_SURRENDER;
+            } else if (action == ACTION_DOUBLE && state.canDouble) {
+                action = ACTION_DOUBLE;
+            } else if (action == ACTION_HIT || action == ACTION_DOUBLE) {
+                action = ACTION_HIT;
+            } else {
+                action = ACTION_STAND;
+            }
+            opening = opening == NO_ACTION ? action : opening;
+
+            if (action == ACTION_SURRENDER) {
+                hand.surrendered = true;
+                return;
+            } else if (action == ACTION_DOUBLE) {
+                doubleDown(seat);
+                return;
+            } else if (action == ACTION_HIT) {
+                hand.add(draw());
+            } else {
+                return;
+            }
+        }
+    }
+
+    Rules rules;
+    MultiDeck& shoe;
+    Table table;
+    Hand house;
+    double seatNet[MAX_SEATS];
+    int opening[MAX_SEATS];
+    Card dealt[MAX_SEATS][2];
+    CountingSystem countingSystem = COUNT_HI_LO;
+    bool holeHidden = false; /// The hole card is dealt but not yet counted.
+};
+
+
+#endif // ENGINE_H
@@ -0,0 +1,52 @@
+#ifndef HAND_H
+#define HAND_H
+
+#include "headers/DeckSetup.h"
+#include "headers/handvalue.h"
+
+/**
+ * @file hand.h
+ * @brief Fixed-capacity hand storage shared by the player seat and the engine.
+ *
+ * A Hand keeps its cards inline, and a seat keeps all of its split hands in one array of
+ * Hands, so dealing, hitting and splitting never allocate.
+ */
+
+
+constexpr int MAX_HAND_CARDS = 24; /// More cards than any hand can hold without busting, plus one.
+constexpr int MAX_SPLIT_HANDS = 8; /// Most hands one seat can be split into under any RuleSet.
+
+
+/**
+ * @struct Hand
+ * @brief Cards and wager of one hand, stored inline.
+ */
+struct Hand {
+    Card cards[MAX_HAND_CARDS];
+    int count = 0;
+    double bet = 1.0;         /// Amount wagered on the hand, in betting units.
+    bool doubled = false;
+    bool surrendered = false;
+    bool fromSplit = false;   /// The hand was made by splitting a pair, so 21 is not a blackjack.
+
+    void clear() {
+        count = 0;
+        bet = 1.0;
+        doubled = false;
+        surrendered = false;
+        fromSplit = false;
+    }
+
+    void add(const Card& card) { cards[count++] = card; }
+    HandValue value() const { return evaluateHand(cards, count); }
+    bool isNatural() const { return count == 2 && !fromSplit && value().total == 21; }
+
+    /// True for a two-card hand whose cards have the same value; tens of any rank pair up.
+    bool isPair() const { return count == 2 && cards[0].value == cards[1].value; }
+
+    /// True if the hand started from a split ace.
+    bool isSplitAces() const { return fromSplit && cards[0].isAce(); }
+};
+
+
+#endif // HAND_H
@@ -0,0 +1,53 @@
+#ifndef HANDVALUE_H
+#define HANDVALUE_H
+
+#include <cstddef>
+#include <vector>
+#include "headers/DeckSetup.h"
+
+/**
+ * @file handvalue.h
+ * @brief Numeric hand evaluation and outcome codes.
+ *
+ * Declares the plain value types the game logic uses to describe a hand and the result of
+ * comparing it against the dealer. Nothing here formats text; turning these values into
+ * strings is left to the UI layer.
+ */
+
+
+
+/**
+ * @enum HandOutcome
+ * @brief Result of comparing a player's hand against the dealer's.
+ *
+ * The numeric values match the codes dealer::CompareHands has always returned
+ * (0 for dealer wins, 1 for player wins, 2 for tie).
+ */
+enum HandOutcome { OUTCOME_LOSE = 0, OUTCOME_WIN = 1, OUTCOME_PUSH = 2 };
+
+
+/**
+ * @struct HandValue
+ * @brief Evaluated total of a hand.
+ *
+ * The total is the best value not exceeding 21 when one exists, counting a single ace as 11
+ * if that does not bust the hand.
+ */
+struct HandValue {
+    int total = 0;      /// Best total of the hand.
+    bool bust = false;  /// True if the total exceeds 21.
+    bool soft = false;  /// True if an ace is being counted as 11.
+};
+
+
+HandValue evaluateHand(const Card *cards, std::size_t count);
+
+/// Evaluates a hand stored in a vector of cards.
+inline HandValue evaluateHand(const std::vector<Card>& hand) {
+    return evaluateHand(hand.data(), hand.size());
+}
+
+HandOutcome compareHandValues(const HandValue& dealerValue, const HandValue& playerValue);
+
+
+#endif // HANDVALUE_H
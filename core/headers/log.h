@@ -0,0 +1,83 @@
+#ifndef LOG_H
+#define LOG_H
+
+/**
+ * @file log.h
+ * @brief Leveled logging with compile-time filtering.
+ *
+ * Messages are written with the LOG_DEBUG, LOG_INFO, LOG_WARN and LOG_ERROR macros using
+ * printf-style format strings. Any level below BJ_LOG_LEVEL is compiled out, so disabled
+ * levels cost nothing at run time, not even argument evaluation. Enabled messages are
+ * formatted into a fixed-size ring buffer and written out by a background thread, so the
+ * calling thread never blocks on I/O.
+ *
+ * Set the level at build time, e.g. DEFINES += BJ_LOG_LEVEL=BJ_LOG_LEVEL_DEBUG.
+ */
+
+#include <cstdio>
+
+#define BJ_LOG_LEVEL_DEBUG 0
+#define BJ_LOG_LEVEL_INFO  1
+#define BJ_LOG_LEVEL_WARN  2
+#define BJ_LOG_LEVEL_ERROR 3
+#define BJ_LOG_LEVEL_OFF   4
+
+#ifndef BJ_LOG_LEVEL
+#define BJ_LOG_LEVEL BJ_LOG_LEVEL_INFO
+#endif
+
+
+namespace logging {
+
+/**
+ * @enum Level
+ * @brief Severity of a log message.
+ */
+enum Level {
+    LEVEL_DEBUG = BJ_LOG_LEVEL_DEBUG,
+    LEVEL_INFO = BJ_LOG_LEVEL_INFO,
+    LEVEL_WARN = BJ_LOG_LEVEL_WARN,
+    LEVEL_ERROR = BJ_LOG_LEVEL_ERROR
+};
+
+#if defined(__GNUC__)
+void write(Level level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+#else
+void write(Level level, const char *format, ...);
+#endif
+
+void setOutput(std::FILE *stream); /// Selects where the background writer sends messages (stderr by default).
+void flush();                      /// Blocks until every message queued so far has been written.
+
+} // namespace logging
+
+
+// Disabled levels still type-check their arguments but never evaluate them.
+#define BJ_LOG_DISCARD(...) do { if (false) ::logging::write(::logging::LEVEL_DEBUG, __VA_ARGS__); } while (0)
+
+#if BJ_LOG_LEVEL <= BJ_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) ::logging::write(::logging::LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) BJ_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if BJ_LOG_LEVEL <= BJ_LOG_LEVEL_INFO
+#define LOG_INFO(...) ::logging::write(::logging::LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) BJ_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if BJ_LOG_LEVEL <= BJ_LOG_LEVEL_WARN
+#define LOG_WARN(...) ::logging::write(::logging::LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) BJ_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if BJ_LOG_LEVEL <= BJ_LOG_LEVEL_ERROR
+#define LOG_ERROR(...) ::logging::write(::logging::LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) BJ_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+
+#endif // LOG_H
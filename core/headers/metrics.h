@@ -0,0 +1,146 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+/**
+ * @file metrics.h
+ * @brief Runtime counters, gauges and latency histograms with a text exporter.
+ *
+ * Metrics are global objects that register themselves by name when constructed. Updating a
+ * metric is a single relaxed atomic operation, so instrumentation can stay in the game
+ * logic permanently. A background exporter periodically renders every registered metric in
+ * the Prometheus text exposition format, either to a file (replaced atomically on each
+ * snapshot) or to a Unix domain socket that sends a fresh snapshot to each client that
+ * connects.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+
+namespace metrics {
+
+/**
+ * @class Counter
+ * @brief Monotonically increasing count.
+ */
+class Counter {
+public:
+    Counter(const char *name, const char *help);
+
+    void add(std::uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+    std::uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+    const char *name;
+    const char *help;
+
+private:
+    std::atomic<std::uint64_t> value{0};
+};
+
+
+/**
+ * @class Gauge
+ * @brief Value that can go up and down, such as a balance.
+ */
+class Gauge {
+public:
+    Gauge(const char *name, const char *help);
+
+    void set(double amount) { value.store(amount, std::memory_order_relaxed); }
+    double get() const { return value.load(std::memory_order_relaxed); }
+
+    const char *name;
+    const char *help;
+
+private:
+    std::atomic<double> value{0.0};
+};
+
+
+/**
+ * @class Histogram
+ * @brief Latency distribution in microseconds using power-of-two buckets.
+ *
+ * Bucket i counts observations up to 2^i microseconds; the last bucket is unbounded.
+ */
+class Histogram {
+public:
+    static constexpr int BUCKET_COUNT = 24;
+
+    Histogram(const char *name, const char *help);
+
+    void observe(std::uint64_t microseconds);
+
+    std::uint64_t bucket(int index) const { return buckets[index].load(std::memory_order_relaxed); }
+    std::uint64_t count() const { return observations.load(std::memory_order_relaxed); }
+    std::uint64_t sum() const { return total.load(std::memory_order_relaxed); }
+
+    const char *name;
+    const char *help;
+
+private:
+    std::atomic<std::uint64_t> buckets[BUCKET_COUNT] = {};
+    std::atomic<std::uint64_t> observations{0};
+    std::atomic<std::uint64_t> total{0};
+};
+
+
+/**
+ * @class ScopedTimer
+ * @brief Observes the lifetime of a block in a latency histogram.
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram &histogram)
+        : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        histogram.observe((std::uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Histogram &histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+
+// Game metrics
+extern Counter handsPlayed;
+extern Counter shuffles;
+extern Counter reshuffles;
+extern Gauge walletBalance;
+
+// GameUI slot latencies
+extern Histogram dealLatency;
+extern Histogram hitLatency;
+extern Histogram standLatency;
+extern Histogram doubleLatency;
+extern Histogram endRoundLatency;
+
+// Background calculations
+extern Histogram adviceLatency;
+
+std::uint64_t allocationCount();
+
+std::string snapshot();
+
+bool startFileExporter(const std::string &path, std::chrono::milliseconds interval);
+bool startSocketExporter(const std::string &path);
+void stopExporter();
+void startFromEnvironment();
+
+} // namespace metrics
+
+
+#define BJ_METRICS_CONCAT_INNER(a, b) a##b
+#define BJ_METRICS_CONCAT(a, b) BJ_METRICS_CONCAT_INNER(a, b)
+#define METRICS_TIME(histogram) ::metrics::ScopedTimer BJ_METRICS_CONCAT(metricsTimer_, __LINE__)(histogram)
+
+
+#endif // METRICS_H
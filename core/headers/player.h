@@ -0,0 +1,90 @@
+
+
+#ifndef GROUP13_PLAYER_H
+#define GROUP13_PLAYER_H
+#include "headers/DeckSetup.h"
+#include "headers/hand.h"
+#include "headers/handvalue.h"
+/**
+ * @file player.h
+ * @brief Declaration of the player class for card game operations.
+ *
+ * Defines the player class, including actions such as hitting, standing, splitting,
+ * and doubling down, as well as managing the player's hand.
+ *
+ * @author Hsioa Yuan Lu
+ */
+
+
+
+
+/**
+ * @class player
+ * @brief Represents a player in a card game.
+ *
+ * This class includes functionalities for player actions such as hit, stand, split,
+ * and double down. It also manages the player's hands and calculates hand values. A seat
+ * holds up to MAX_SPLIT_HANDS hands in a fixed array, so splitting never allocates.
+ */
+class player {
+public:
+
+    Hand hands[MAX_SPLIT_HANDS]; /// The seat's hands; only the first handCount are in play.
+    int handCount = 1;           /// Number of hands, more than one after a split.
+    int activeHand = 0;          /// Index of the hand currently being played.
+    bool insured = false;        /// Took insurance, or even money when holding a blackjack.
+
+    MultiDeck* deck; /// Pointer to a MultiDeck instance
+
+    player(MultiDeck* deck = nullptr) : deck(deck) {} /// Constructor to set the deck
+
+    void Hit();
+    void Stand();
+    void Split();
+    void Double();
+
+    /// Split() and Double() without the draws, for a caller that deals from its own shoe.
+    Hand& SplitPair();
+    void DoubleBet();
+
+    /// Clears every hand and goes back to a single empty hand.
+    void Reset();
+
+    /**
+     * @brief Moves on to the next split hand.
+     * @return False if the active hand was the seat's last hand.
+     */
+    bool NextHand();
+
+    /**
+     * @brief Whether the active hand may be split.
+     * @param maxHands Most hands the seat may hold, from RuleSet::maxSplitHands.
+     * @param resplitAces Whether split aces may be split again.
+     */
+    bool CanSplit(int maxHands, bool resplitAces) const;
+
+    Hand& CurrentHand() { return hands[activeHand]; }
+    const Hand& CurrentHand() const { return hands[activeHand]; }
+
+
+    /**
+     * @brief Evaluates the player's active hand and calculates the total value.
+     * @return A pair of integers representing the minimum and maximum values of the hand,
+     *         accounting for aces as either 1 or 11.
+     */
+    std::pair<int, int> CheckHand();
+    void AddCardToHand(const Card& specificCard);
+
+    /**
+     * @brief Evaluates the player's active hand as plain numbers.
+     * @return The best total of the hand with its bust and soft flags.
+     */
+    HandValue GetHandValue() const;
+
+    /// True if the seat holds an unsplit two-card 21.
+    bool HasBlackjack() const { return handCount == 1 && hands[0].isNatural(); }
+};
+
+
+#endif //GROUP13_PLAYER_H
+
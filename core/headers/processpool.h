@@ -0,0 +1,45 @@
+#ifndef PROCESSPOOL_H
+#define PROCESSPOOL_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @file processpool.h
+ * @brief Work shared out between forked worker processes, so a crash loses only one shard.
+ *
+ * A long job is cut into numbered shards whose results do not depend on where or when they
+ * run, such as fixed rounds from a seed of their own. runShardsInProcesses() forks worker
+ * processes, hands each one shard at a time over a pipe and reads its result back over
+ * another as soon as it is done. A worker that dies, whether it crashes, runs out of memory
+ * or is killed, takes only the shard it was running with it: the coordinator notices the
+ * pipe close, reaps it, starts a replacement and gives the shard another attempt, and once
+ * its attempts are used up reports it as lost. Each worker has its own address space, so
+ * the job is not limited to one process's memory either.
+ *
+ * Results are handed back per shard, so the caller can combine them in shard order and get
+ * the same answer however many workers ran and whichever finished first. Where fork() is
+ * not available the shards simply run one after another in the calling process.
+ */
+
+
+/**
+ * @brief Runs shards in worker processes.
+ *
+ * The calling process only coordinates; it should not have other threads running, since
+ * only the forking thread is copied into a worker.
+ * @param order Shards to run, in the order they are handed out.
+ * @param processes Most workers alive at once.
+ * @param attempts Times a shard is started before it is given up, at least one.
+ * @param work Run in a worker for each shard; returns its result as bytes.
+ * @param done Run in the calling process as each shard finishes, with its result, or with
+ *        nullptr if it was lost.
+ * @return Number of shards lost.
+ */
+int runShardsInProcesses(const std::vector<int>& order, int processes, int attempts,
+                         const std::function<std::string(int)>& work,
+                         const std::function<void(int, const std::string *)>& done);
+
+
+#endif // PROCESSPOOL_H
@@ -0,0 +1,96 @@
+#ifndef REMOVAL_H
+#define REMOVAL_H
+
+#include <string>
+#include <vector>
+#include "headers/composition.h"
+#include "headers/engine.h"
+#include "headers/rules.h"
+
+/**
+ * @file removal.h
+ * @brief Effects of removal and how well a counting system tracks them.
+ *
+ * The effect of removal of a rank is how much the player's expected value changes when
+ * cards of that rank are taken out of the shoe. Here it is measured exactly, with
+ * analyzeShoe(), by taking one card of the rank out per deck, so the figures read as the
+ * usual single-deck ones whatever the shoe. The same analyses give the effect of removal on
+ * every starting decision: how the gap between its best and second-best action moves.
+ *
+ * A count is a linear estimate of those effects, and evaluateCount() scores it the usual
+ * three ways. The betting correlation is the correlation between its tags and the effects
+ * on the expected value, and the insurance correlation that between its tags and the
+ * effects on insurance, which depends only on tens. The playing efficiency compares, over
+ * the starting decisions, the gain the count can make by changing the play with the true
+ * count against the gain of knowing each decision's effects exactly. Both are worked out
+ * with the normal approximation: with gap g and spread s of the change in the gap halfway
+ * into the dealt part of the shoe, perfect knowledge gains s phi(g/s) - g Q(g/s), and a
+ * count with correlation r to the decision's effects gains the same with r s for s.
+ */
+
+
+/**
+ * @struct DecisionEffect
+ * @brief A starting hand against an upcard, and how the count moves its decision.
+ */
+struct DecisionEffect {
+    int upcard;               /// Rank indices.
+    int first;
+    int second;               /// At least first.
+    Action best;              /// Best and second-best actions off the top of the shoe.
+    Action runnerUp;
+    double frequency;         /// Chance of being dealt the hand against the upcard.
+    double gap;               /// Value of best less runnerUp off the top of the shoe.
+    double effect[RANKS];     /// Change in the gap with one card of each rank per deck removed.
+};
+
+
+/**
+ * @struct RemovalEffects
+ * @brief Effects of removal of every rank on a round and on every starting decision.
+ */
+struct RemovalEffects {
+    RuleSet rules;
+    double expectedValue = 0.0;  /// Of a round off the top, per unit bet.
+    double effect[RANKS] = {};   /// Change in expected value with one card per deck removed.
+    std::vector<DecisionEffect> decisions;
+
+    /// The results as text, for a ResultCache; rules are not included.
+    std::string serialize() const;
+
+    /// Reads serialize() text; returns false, leaving the results unchanged, if it is not.
+    bool parse(const std::string& text);
+};
+
+
+/**
+ * @brief Computes effects of removal for several rule sets.
+ *
+ * Each rule set needs one analysis of the full shoe and one per rank removed. All of them
+ * are shared out between the threads together, so a single rule set still uses up to
+ * eleven threads and many rule sets keep every thread busy.
+ * @param threads Worker threads; 0 uses one per hardware thread.
+ * @return The effects, in the order of the rule sets.
+ */
+std::vector<RemovalEffects> computeRemovalEffects(const std::vector<RuleSet>& rules, int threads = 0);
+
+
+/**
+ * @struct CountEvaluation
+ * @brief How well a counting system's tags track the effects of removal.
+ */
+struct CountEvaluation {
+    double betting = 0.0;    /// Betting correlation.
+    double playing = 0.0;    /// Playing efficiency.
+    double insurance = 0.0;  /// Insurance correlation.
+};
+
+
+/**
+ * @brief Scores a counting system against the effects of removal.
+ * @param tags The system's tag for each rank, ace first and tens last.
+ */
+CountEvaluation evaluateCount(const RemovalEffects& effects, const int tags[RANKS]);
+
+
+#endif // REMOVAL_H
@@ -0,0 +1,152 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @file rules.h
+ * @brief Table rule descriptions and their compile-time specialisations.
+ *
+ * RuleSet describes a table at run time. The engine is a template on a rules class rather
+ * than on RuleSet directly: DynamicRules answers every rule question by reading the
+ * RuleSet, while StaticRules fixes the rules that are checked inside the hand loop (dealer
+ * hits soft 17, double after split, peek, surrender, blackjack payout) as template
+ * arguments, so those checks compile down to constants. withRules() picks the matching
+ * specialisation for the common tables and falls back to DynamicRules for anything else.
+ */
+
+
+/**
+ * @enum SurrenderRule
+ * @brief When, if ever, a player may give up half their bet.
+ */
+enum SurrenderRule {
+    SURRENDER_NONE,
+    SURRENDER_LATE,  /// After the dealer has checked for blackjack.
+    SURRENDER_EARLY  /// Before the dealer checks for blackjack.
+};
+
+
+/**
+ * @struct RuleSet
+ * @brief Run-time description of a blackjack table's rules.
+ *
+ * The defaults are the rules the game has always played: six decks, dealer stands on all
+ * 17s, with blackjack paying 3:2.
+ */
+struct RuleSet {
+    int decks = 6;                      /// Number of decks in the shoe (1 to 8).
+    bool hitSoft17 = false;             /// True for H17, false for S17.
+    int blackjackPayNumerator = 3;      /// Blackjack pays numerator:denominator.
+    int blackjackPayDenominator = 2;
+    bool doubleAfterSplit = true;       /// DAS.
+    int maxSplitHands = 4;              /// Most hands one seat can split into.
+    bool resplitAces = false;           /// Whether split aces may be split again.
+    bool hitSplitAces = false;          /// Whether split aces may draw more than one card.
+    SurrenderRule surrender = SURRENDER_NONE;
+    bool dealerPeek = true;             /// False for ENHC (no hole card checked).
+    double penetration = 0.75;          /// Fraction of the shoe dealt before reshuffling.
+
+    double blackjackPayout() const { return double(blackjackPayNumerator) / blackjackPayDenominator; }
+
+    bool isValid() const;
+    std::uint64_t hash() const;
+    std::string describe() const;
+};
+
+
+/**
+ * @class DynamicRules
+ * @brief Rules policy that reads every rule from a RuleSet at run time.
+ */
+class DynamicRules {
+public:
+    explicit DynamicRules(const RuleSet& rules) : rules(rules) {}
+
+    bool hitSoft17() const { return rules.hitSoft17; }
+    bool doubleAfterSplit() const { return rules.doubleAfterSplit; }
+    bool dealerPeek() const { return rules.dealerPeek; }
+    SurrenderRule surrender() const { return rules.surrender; }
+    double blackjackPayout() const { return rules.blackjackPayout(); }
+
+    int decks() const { return rules.decks; }
+    int maxSplitHands() const { return rules.maxSplitHands; }
+    bool resplitAces() const { return rules.resplitAces; }
+    bool hitSplitAces() const { return rules.hitSplitAces; }
+    double penetration() const { return rules.penetration; }
+
+    const RuleSet& ruleSet() const { return rules; }
+
+protected:
+    RuleSet rules;
+};
+
+
+/**
+ * @class StaticRules
+ * @brief Rules policy with the hand-loop rules fixed at compile time.
+ *
+ * The static member functions hide the DynamicRules versions, so an engine instantiated on
+ * a StaticRules type sees them as constants. Shoe size and split limits are still read
+ * from the RuleSet.
+ */
+template <bool H17, bool DAS, bool Peek, SurrenderRule Surrender, int PayNumerator, int PayDenominator>
+class StaticRules : public DynamicRules {
+public:
+    explicit StaticRules(const RuleSet& rules) : DynamicRules(rules) {}
+
+    static constexpr bool hitSoft17() { return H17; }
+    static constexpr bool doubleAfterSplit() { return DAS; }
+    static constexpr bool dealerPeek() { return Peek; }
+    static constexpr SurrenderRule surrender() { return Surrender; }
+    static constexpr double blackjackPayout() { return double(PayNumerator) / PayDenominator; }
+
+    /// True if the fixed rules agree with the given RuleSet.
+    static bool matches(const RuleSet& rules) {
+        return rules.hitSoft17 == H17 && rules.doubleAfterSplit == DAS && rules.dealerPeek == Peek
+            && rules.surrender == Surrender
+            && rules.blackjackPayNumerator * PayDenominator == rules.blackjackPayDenominator * PayNumerator;
+    }
+};
+
+
+// The tables most commonly simulated get their own specialisation.
+using RulesS17Das = StaticRules<false, true, true, SURRENDER_NONE, 3, 2>;
+using RulesH17Das = StaticRules<true, true, true, SURRENDER_NONE, 3, 2>;
+using RulesS17DasLateSurrender = StaticRules<false, true, true, SURRENDER_LATE, 3, 2>;
+using RulesH17DasLateSurrender = StaticRules<true, true, true, SURRENDER_LATE, 3, 2>;
+using RulesH17NoDasSixFive = StaticRules<true, false, true, SURRENDER_NONE, 6, 5>;
+using RulesS17DasNoHoleCard = StaticRules<false, true, false, SURRENDER_NONE, 3, 2>;
+
+
+/**
+ * @brief Calls a function with the most specialised rules policy for a RuleSet.
+ * @param rules The table rules.
+ * @param function Generic callable taking a rules policy by value; every instantiation must
+ *        return the same type.
+ * @return Whatever the function returns.
+ */
+template <class Function>
+auto withRules(const RuleSet& rules, Function&& function) -> decltype(function(DynamicRules(rules))) {
+    if (RulesS17Das::matches(rules)) {
+        return function(RulesS17Das(rules));
+    } else if (RulesH17Das::matches(rules)) {
+        return function(RulesH17Das(rules));
+    } else if (RulesS17DasLateSurrender::matches(rules)) {
+        return function(RulesS17DasLateSurrender(rules));
+    } else if (RulesH17DasLateSurrender::matches(rules)) {
+        return function(RulesH17DasLateSurrender(rules));
+    } else if (RulesH17NoDasSixFive::matches(rules)) {
+        return function(RulesH17NoDasSixFive(rules));
+    } else if (RulesS17DasNoHoleCard::matches(rules)) {
+        return function(RulesS17DasNoHoleCard(rules));
+    }
+    return function(DynamicRules(rules));
+}
+
+
+int parseRuleOption(RuleSet& rules, int argc, char *argv[], int index);
+
+
+#endif // RULES_H
@@ -0,0 +1,115 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <random>
+#include <vector>
+#include "headers/DeckSetup.h"
+#include "headers/composition.h"
+#include "headers/counting.h"
+
+/**
+ * @file sampler.h
+ * @brief Shoes dealt to a chosen count or composition, with the chance of getting there.
+ *
+ * Plain simulation spends almost all of its rounds near a true count of zero. The
+ * conditional sampler instead deals shoes straight to a state of interest: a given depth
+ * with the running count in a given range, or a given remaining composition. The cards
+ * already dealt are drawn from their exact distribution under that condition, not by
+ * dealing shoes and throwing away those that miss, and probability() gives the chance a
+ * random shuffle reaches the state, which is the weight to put on results from it when they
+ * are combined back into an unconditional figure.
+ *
+ * Only the tag of a card matters to a count, so the ranks are grouped by tag. For a depth of
+ * d cards, the constructor works out, for every tag sum s, the number of ways to deal d
+ * cards adding to s, class by class (a multivariate hypergeometric count over the tag
+ * classes). Sampling walks those tables backwards to pick how many cards of each class were
+ * dealt, then splits each class between its ranks, so every sample costs O(d) and none is
+ * rejected.
+ */
+
+
+/**
+ * @class ConditionalShoeSampler
+ * @brief Deals shoes to a fixed depth whose dealt cards meet a count or composition condition.
+ *
+ * A sampler is read-only once conditioned, so threads may share it, each with its own
+ * random generator.
+ */
+class ConditionalShoeSampler {
+public:
+    /**
+     * @param decks Decks in the shoe.
+     * @param system The count conditions are expressed in.
+     * @param cardsDealt Cards already dealt when the condition holds.
+     */
+    ConditionalShoeSampler(int decks, CountingSystem system, int cardsDealt);
+
+    /// Conditions on the dealt cards' tags adding up to between low and high inclusive;
+    /// returns false, leaving no condition, if no shoe can meet it.
+    bool conditionOnTagSum(int low, int high);
+
+    /**
+     * @brief Conditions on CardCounter::trueCount() being at least low and below high.
+     *
+     * The count is the one taken once laterCards more cards, whose tags add up to
+     * laterTags, have been seen after the dealt cards, such as a hand about to be played.
+     * @return False if no shoe can meet it.
+     */
+    bool conditionOnTrueCount(double low, double high, int laterTags = 0, int laterCards = 0);
+
+    /// Conditions on exactly these cards being left; returns false unless it is the right
+    /// size and a subset of the full shoe.
+    bool conditionOnRemainder(const ShoeComposition& remaining);
+
+    /// Chance that a uniformly shuffled shoe meets the condition.
+    double probability() const { return chance; }
+
+    int cardsDealt() const { return depth; }
+
+    /// Rank counts of the dealt cards, drawn from their distribution under the condition.
+    ShoeComposition sampleDealt(std::mt19937& rng) const;
+
+    /**
+     * @brief Loads a sampled shoe and deals the conditioned cards out of it.
+     *
+     * The dealt cards and the rest are each in uniformly random order, and the dealt cards
+     * go through MultiDeck::drawCard(), so the shoe's counts are those of the condition.
+     * @param shoe A shoe with the sampler's number of decks.
+     */
+    void deal(MultiDeck& shoe, std::mt19937& rng) const;
+
+private:
+    /// Cards of the ranks sharing one tag.
+    struct TagClass {
+        int tag;
+        int cards;
+        std::vector<int> ranks;
+        std::vector<double> choose; /// choose[j]: ways to pick j of the class's cards.
+    };
+
+    double& ways(int classes, int dealt, int tagSum) {
+        return table[(std::size_t(classes) * (depth + 1) + dealt) * sums + tagSum + offset];
+    }
+    double ways(int classes, int dealt, int tagSum) const {
+        return table[(std::size_t(classes) * (depth + 1) + dealt) * sums + tagSum + offset];
+    }
+
+    int decks;
+    CountingSystem system;
+    int depth;
+    ShoeComposition full;
+    std::vector<TagClass> classes;
+    int offset;                  /// Largest possible |tag sum| of the dealt cards.
+    int sums;                    /// 2 * offset + 1 tag sums.
+    std::vector<double> table;   /// Ways to deal a number of cards with a tag sum from the first classes.
+    std::vector<double> allowed; /// Ways to deal depth cards for each tag sum the condition allows.
+    double total;                /// Ways to deal depth cards from the full shoe.
+    double chance = 1.0;
+    bool fixedRemainder = false;
+    ShoeComposition fixedDealt;
+    std::vector<Card> cards;     /// A full shoe, grouped by rank.
+    int rankStart[RANKS];        /// Index in cards of each rank's first card.
+};
+
+
+#endif // SAMPLER_H
@@ -0,0 +1,59 @@
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file sketch.h
+ * @brief Fixed-memory streaming quantiles with a relative error bound.
+ *
+ * QuantileSketch keeps a count per logarithmic bucket instead of the values themselves:
+ * bucket i holds values in (gamma^(i-1), gamma^i] with gamma = (1 + a) / (1 - a), so any
+ * quantile it reports is within a relative error a of a value actually seen. The buckets
+ * cover a fixed range chosen up front, memory does not grow with the number of values, and
+ * two sketches with the same settings merge by adding counts, so each thread can keep its
+ * own and combine them at the end.
+ */
+
+
+/**
+ * @class QuantileSketch
+ * @brief Mergeable log-bucketed quantile sketch for non-negative values.
+ */
+class QuantileSketch {
+public:
+    /**
+     * @param relativeAccuracy Largest relative error of a reported quantile.
+     * @param minValue Smallest positive value told apart from zero; smaller values count as
+     *        zero.
+     * @param maxValue Values above this are counted in the top bucket.
+     */
+    explicit QuantileSketch(double relativeAccuracy = 0.01, double minValue = 1e-3, double maxValue = 1e12);
+
+    void add(double value);
+
+    /// Adds another sketch's counts; both must have been made with the same settings.
+    void merge(const QuantileSketch& other);
+
+    /**
+     * @brief Estimated q-quantile of the values added.
+     * @param q From 0 (smallest) to 1 (largest).
+     * @return The estimate, or 0 if the sketch is empty.
+     */
+    double quantile(double q) const;
+
+    std::uint64_t count() const { return total; }
+
+private:
+    double gamma;
+    double logGamma;
+    double minValue;
+    int offset;                         /// Bucket index of minValue.
+    std::uint64_t zeros = 0;            /// Values below minValue.
+    std::uint64_t total = 0;
+    std::vector<std::uint64_t> buckets;
+};
+
+
+#endif // SKETCH_H
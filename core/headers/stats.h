@@ -0,0 +1,111 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstdint>
+
+/**
+ * @file stats.h
+ * @brief Streaming mean, variance, higher moments and covariance.
+ *
+ * RunningStats takes one value at a time and keeps only the count, the mean and the
+ * central moment sums, updated with Welford's method, so results need neither a second pass
+ * nor a store of the values and do not lose precision over billions of hands the way plain
+ * sums of squares do. Two RunningStats merge exactly, so each simulation thread keeps its
+ * own and they are combined as the threads report.
+ */
+
+
+constexpr double CONFIDENCE_95 = 1.959963984540054; /// Two-sided 95% normal quantile.
+
+
+/**
+ * @class RunningStats
+ * @brief Count, mean and second to fourth central moments of a stream of values.
+ */
+class RunningStats {
+public:
+    void add(double value);
+    void merge(const RunningStats& other);
+
+    std::uint64_t count() const { return n; }
+    double mean() const { return average; }
+
+    /// Sample variance; 0 with fewer than two values.
+    double variance() const { return n > 1 ? m2 / (n - 1) : 0.0; }
+    double standardDeviation() const;
+
+    /// Standard error of the mean.
+    double standardError() const;
+
+    /// Half-width of the normal confidence interval of the mean at quantile z.
+    double confidenceHalfWidth(double z = CONFIDENCE_95) const { return z * standardError(); }
+
+    double skewness() const;
+
+    /// Kurtosis less 3, so a normal distribution gives 0.
+    double excessKurtosis() const;
+
+    /// Everything the statistics are made from, to store them and read them back exactly.
+    struct State {
+        std::uint64_t n;
+        double mean;
+        double m2;
+        double m3;
+        double m4;
+    };
+
+    State state() const { return State{n, average, m2, m3, m4}; }
+
+    static RunningStats fromState(const State& state) {
+        RunningStats stats;
+        stats.n = state.n;
+        stats.average = state.mean;
+        stats.m2 = state.m2;
+        stats.m3 = state.m3;
+        stats.m4 = state.m4;
+        return stats;
+    }
+
+private:
+    std::uint64_t n = 0;
+    double average = 0.0;
+    double m2 = 0.0; /// Sums of powers of deviations from the mean.
+    double m3 = 0.0;
+    double m4 = 0.0;
+};
+
+
+/**
+ * @class RunningCovariance
+ * @brief Streaming means, variances and covariance of pairs of values.
+ *
+ * Used for control variates: y is the value estimated, x a value with a known mean that
+ * moves with it.
+ */
+class RunningCovariance {
+public:
+    void add(double x, double y);
+    void merge(const RunningCovariance& other);
+
+    std::uint64_t count() const { return n; }
+    double meanX() const { return averageX; }
+    double meanY() const { return averageY; }
+    double varianceX() const { return n > 1 ? m2x / (n - 1) : 0.0; }
+    double varianceY() const { return n > 1 ? m2y / (n - 1) : 0.0; }
+    double covariance() const { return n > 1 ? cxy / (n - 1) : 0.0; }
+    double correlation() const;
+
+    /// Least-squares slope of y on x, the control variate's coefficient.
+    double slope() const { return m2x > 0.0 ? cxy / m2x : 0.0; }
+
+private:
+    std::uint64_t n = 0;
+    double averageX = 0.0;
+    double averageY = 0.0;
+    double m2x = 0.0;
+    double m2y = 0.0;
+    double cxy = 0.0; /// Sum of products of deviations.
+};
+
+
+#endif // STATS_H
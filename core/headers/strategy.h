@@ -0,0 +1,139 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include <vector>
+#include "headers/deviations.h"
+#include "headers/engine.h"
+#include "headers/rules.h"
+
+/**
+ * @file strategy.h
+ * @brief Basic strategy as compile-time lookup tables.
+ *
+ * Every decision the engine asks for is answered from a StrategyTable indexed by which
+ * options the hand has (double, surrender), the row for the hand (hard total, soft total or
+ * pair) and the dealer's upcard. The table already holds the fallback for each option that
+ * is not available, so BasicStrategy::decide is one table load with no branching. One table
+ * per combination of the rules that change basic strategy (H17, DAS, peek) is built at
+ * compile time in strategy.cpp.
+ */
+
+
+constexpr int STRATEGY_ROWS = 42;    /// Hard totals 0-21, soft totals 12-21, pairs 2-11.
+constexpr int STRATEGY_COLUMNS = 12; /// Indexed directly by dealer upcard value, 2 to 11.
+
+
+/// Row of a hard total.
+constexpr int hardRow(int total) { return total; }
+
+/// Row of a soft total, 12 to 21.
+constexpr int softRow(int total) { return 10 + total; }
+
+/// Row of a splittable pair, by the value of one card with an ace as 11.
+constexpr int pairRow(int pairValue) { return 30 + pairValue; }
+
+
+/**
+ * @struct StrategyTable
+ * @brief Actions for every hand against every upcard, for each set of available options.
+ */
+struct StrategyTable {
+    /// [canDouble + 2 * canSurrender][row][dealer upcard], holding Action values.
+    unsigned char action[4][STRATEGY_ROWS][STRATEGY_COLUMNS] = {};
+};
+
+
+/**
+ * @brief The compile-time basic strategy table for a table's rules.
+ *
+ * Late and early surrender use the same surrender plays; the table only decides whether
+ * surrendering beats playing on once the dealer has no blackjack.
+ */
+const StrategyTable& basicStrategyTable(const RuleSet& rules);
+
+
+/**
+ * @class BasicStrategy
+ * @brief Engine strategy playing multi-deck basic strategy for the given rules.
+ */
+class BasicStrategy {
+public:
+    explicit BasicStrategy(const RuleSet& rules) : table(&basicStrategyTable(rules)) {}
+
+    Action decide(const HandState& state) const {
+        int row = state.value.soft ? softRow(state.value.total) : hardRow(state.value.total);
+        row = state.canSplit ? pairRow(state.pairValue) : row;
+        int options = int(state.canDouble) | int(state.canSurrender) << 1;
+        return Action(table->action[options][row][state.dealerUpcard]);
+    }
+
+    /// Basic strategy never takes insurance or even money.
+    bool takeInsurance(const HandState&) const { return false; }
+
+private:
+    const StrategyTable* table;
+};
+
+
+/**
+ * @class CountingStrategy
+ * @brief Basic strategy that insures, or takes even money, once the true count is high.
+ *
+ * Insurance pays when more than a third of the unseen cards are tens. The default index of
+ * +3 is the Hi-Lo one; other systems need their own.
+ */
+class CountingStrategy : public BasicStrategy {
+public:
+    explicit CountingStrategy(const RuleSet& rules, double insuranceIndex = 3.0)
+        : BasicStrategy(rules), insuranceIndex(insuranceIndex) {}
+
+    bool takeInsurance(const HandState& state) const { return state.trueCount >= insuranceIndex; }
+
+private:
+    double insuranceIndex;
+};
+
+
+/**
+ * @class IndexStrategy
+ * @brief Basic strategy with the deviations and insurance index of an IndexTable.
+ *
+ * The table's plays are laid out by row and upcard when the strategy is made, so a decision
+ * costs one more load than basic strategy. A pair that basic strategy does not split, and
+ * that has no deviation of its own, plays the deviations of its total, so 5,5 doubles as
+ * 10 does. A deviation whose action the hand cannot take (a double or surrender after the
+ * first decision) leaves basic strategy in place. Without
+ * an insurance index in the table it never insures.
+ */
+class IndexStrategy : public BasicStrategy {
+public:
+    IndexStrategy(const RuleSet& rules, const IndexTable& table);
+
+    Action decide(const HandState& state) const {
+        Action basic = BasicStrategy::decide(state);
+        int row = state.value.soft ? softRow(state.value.total) : hardRow(state.value.total);
+        int slot = state.canSplit ? slots[pairRow(state.pairValue)][state.dealerUpcard] : -1;
+        if (slot < 0 && basic != ACTION_SPLIT) {
+            slot = slots[row][state.dealerUpcard];
+        }
+        if (slot < 0 || !plays[slot].applies(state.trueCount)) {
+            return basic;
+        }
+        Action action = plays[slot].action;
+        if ((action == ACTION_DOUBLE && !state.canDouble) || (action == ACTION_SURRENDER && !state.canSurrender)) {
+            return basic;
+        }
+        return action;
+    }
+
+    bool takeInsurance(const HandState& state) const { return insures && state.trueCount >= insuranceIndex; }
+
+private:
+    std::vector<Deviation> plays;
+    signed char slots[STRATEGY_ROWS][STRATEGY_COLUMNS]; /// Index in plays, or -1 for none.
+    bool insures;
+    double insuranceIndex;
+};
+
+
+#endif // STRATEGY_H
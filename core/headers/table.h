@@ -0,0 +1,43 @@
+#ifndef TABLE_H
+#define TABLE_H
+
+#include "headers/DeckSetup.h"
+#include "headers/player.h"
+
+/**
+ * @file table.h
+ * @brief The seats at a blackjack table.
+ *
+ * Table keeps every seat in one preallocated array, so seating players and dealing rounds
+ * never allocate. Both the engine and GameUI play their rounds on a Table; seats are always
+ * filled from index 0, and anything that lays seats out works from the seat index alone.
+ */
+
+
+constexpr int MAX_SEATS = 7; /// Seats at a full table.
+
+
+/**
+ * @struct Table
+ * @brief Up to MAX_SEATS seats drawing from one shoe; seats 0 to seatCount - 1 are in play.
+ */
+struct Table {
+    player seats[MAX_SEATS];
+    int seatCount = 0;
+
+    explicit Table(MultiDeck* shoe, int seatCount = 0);
+
+    /// Seats one more player; returns false if the table is full.
+    bool addSeat();
+
+    /// Empties the table.
+    void clear();
+
+    /// Clears the hands of every seat in play, ready for the next round.
+    void resetHands();
+
+    bool isFull() const { return seatCount >= MAX_SEATS; }
+};
+
+
+#endif // TABLE_H
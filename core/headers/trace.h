@@ -0,0 +1,72 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/**
+ * @file trace.h
+ * @brief Scoped trace spans written out as Chrome trace JSON.
+ *
+ * Place TRACE_SCOPE("name") at the top of a block to record how long the block takes. Spans
+ * are stored in a fixed-size buffer owned by the recording thread, so recording never takes
+ * a lock. The collected spans can be written as Chrome trace event JSON and opened in
+ * chrome://tracing or ui.perfetto.dev.
+ *
+ * Tracing is only compiled in when BJ_TRACE is defined (CONFIG += trace in qmake); otherwise
+ * TRACE_SCOPE expands to nothing. When compiled in, recording is still off until
+ * tracing::setEnabled(true) or tracing::startFromEnvironment() turns it on, and a disabled
+ * span costs a single relaxed load.
+ */
+
+#include <atomic>
+#include <cstdint>
+
+
+namespace tracing {
+
+extern std::atomic<bool> recording;
+
+void setEnabled(bool enabled);
+bool writeChromeTrace(const char *path);
+void startFromEnvironment();
+
+std::uint64_t nowNanoseconds();
+void record(const char *name, std::uint64_t startNs, std::uint64_t endNs);
+
+
+/**
+ * @class ScopedSpan
+ * @brief Records the lifetime of a block as one complete trace event.
+ *
+ * The name must be a string literal or otherwise outlive the trace dump.
+ */
+class ScopedSpan {
+public:
+    explicit ScopedSpan(const char *name)
+        : name(name), start(recording.load(std::memory_order_relaxed) ? nowNanoseconds() : 0) {}
+
+    ~ScopedSpan() {
+        if (start != 0) {
+            record(name, start, nowNanoseconds());
+        }
+    }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+private:
+    const char *name;
+    std::uint64_t start;
+};
+
+} // namespace tracing
+
+
+#ifdef BJ_TRACE
+#define BJ_TRACE_CONCAT_INNER(a, b) a##b
+#define BJ_TRACE_CONCAT(a, b) BJ_TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) ::tracing::ScopedSpan BJ_TRACE_CONCAT(traceSpan_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
+
+
+#endif // TRACE_H
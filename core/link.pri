@@ -0,0 +1,14 @@
+# Include from a project that links against the core static library.
+
+include(core.pri)
+
+CORE_OUT = $$shadowed($$PWD)
+
+win32:CONFIG(release, debug|release): CORE_LIB_DIR = $$CORE_OUT/release
+else:win32:CONFIG(debug, debug|release): CORE_LIB_DIR = $$CORE_OUT/debug
+else: CORE_LIB_DIR = $$CORE_OUT
+
+LIBS += -L$$CORE_LIB_DIR -lcore
+
+win32-g++|!win32: PRE_TARGETDEPS += $$CORE_LIB_DIR/libcore.a
+else: PRE_TARGETDEPS += $$CORE_LIB_DIR/core.lib
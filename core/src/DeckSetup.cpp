@@ -0,0 +1,268 @@
+#include "headers/DeckSetup.h"
+#include "headers/checkpoint.h"
+#include "headers/trace.h"
+#include "headers/metrics.h"
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+
+/**
+ * @file DeckSetup.cpp
+ * @brief Implementation for deck setup and management for card games.
+ *
+ * Contains the implementation of card, deck, and multideck functionalities,
+ * such as generating decks, shuffling, and drawing cards.
+ *
+ * @author Hsiao Yuan Lu
+ */
+
+
+
+
+/// Determines if a card is an Ace.
+/// @return True if the card is an Ace, false otherwise.
+bool Card::isAce() const
+{
+    return name == ACE;
+}
+
+
+/// Gets the name of the card's rank.
+/// @return "Ace", "Jack", "Queen", "King", or the card's number.
+const char *Card::rankName() const {
+    static const char *const names[] = {"Ace", "2", "3", "4", "5", "6", "7", "8", "9", "10", "Jack", "Queen", "King"};
+    return names[name];
+}
+
+/// Gets the name of the card's suit.
+/// @return "Clubs", "Diamonds", "Hearts" or "Spades".
+const char *Card::suitName() const {
+    switch (suit) {
+    case Suits::CLUBS: return "Clubs";
+    case Suits::DIAMONDS: return "Diamonds";
+    case Suits::HEARTS: return "Hearts";
+    case Suits::SPADES: return "Spades";
+    default: return "Unknown";
+    }
+}
+
+
+/**
+ * Generates a standard deck of 52 cards.
+ */
+void Deck::generateDeck()
+{
+    for (int col = (int) Suits::CLUBS; col <= (int) Suits::SPADES; col++) {
+        for (int row = (int) CardNames::ACE; row <= (int) CardNames::KING; row++) {
+            Card c;
+            c.suit = (Suits) col;
+            c.name = (CardNames) row;
+
+            if (c.name == CardNames::JACK) {
+                c.value = 10;
+            } else if (c.name == CardNames::QUEEN) {
+                c.value = 10;
+            } else if (c.name == CardNames::KING) {
+                c.value = 10;
+            } else {
+                c.value = (int) c.name + 1;
+            }
+            int index = (13 * col) + row;
+            arrCards[index] = c;
+        }
+    }
+}
+
+
+
+/**
+ * Shuffles the specified deck of cards.
+ * @param decks An array of Card objects representing the deck to shuffle.
+ * @param size The size of the deck to shuffle.
+ */
+void MultiDeck::shuffle(Card *decks, int size)
+{
+    TRACE_SCOPE("shuffle");
+    for (int i = size - 1; i > 0; i--) {
+        std::uniform_int_distribution<int> distribution(0, i);
+        int j = distribution(rng);
+        std::swap(decks[i], decks[j]);
+    }
+}
+
+/**
+ * Creates and shuffles multiple decks to form a single combined deck, or with antithetic
+ * set, reverses the last shuffled order every second time.
+ */
+void MultiDeck::createAndShuffleDecks()
+{
+    Deck deck;
+
+    metrics::shuffles.add();
+    if (!drawnCards.empty()) {
+        metrics::reshuffles.add();
+    }
+
+    if (antithetic && mirrorNext) {
+        std::reverse(allDecks.begin(), allDecks.end());
+        mirrorNext = false;
+    } else {
+        int index = 0;
+        for (int d = 0; d < deckCount; ++d) {
+            deck.generateDeck(); // Generate a new deck
+
+            for (int card = 0; card < 52; ++card) {
+                allDecks[index++] = deck.arrCards[card];
+            }
+        }
+
+        shuffle(allDecks.data(), size());
+        mirrorNext = antithetic;
+    }
+
+    nextCard = 0;
+    counts.reset(deckCount);
+    drawnCards.clear();
+    drawnCards.reserve(size());
+}
+
+
+/**
+ * Reseeds the shoe's random generator.
+ * @param value The seed; every bit of it is used.
+ */
+void MultiDeck::seed(std::uint64_t value)
+{
+    std::seed_seq sequence{(unsigned) (value & 0xffffffffU), (unsigned) (value >> 32)};
+    rng.seed(sequence);
+}
+
+
+/**
+ * Replaces the shoe with a copy of an order shuffled elsewhere and starts dealing it.
+ * @param order The cards in dealing order.
+ * @throw std::invalid_argument if the order does not hold as many cards as the shoe.
+ */
+void MultiDeck::loadShoe(const std::vector<Card>& order)
+{
+    if ((int) order.size() != size()) {
+        throw std::invalid_argument("Shoe order has the wrong number of cards.");
+    }
+    std::copy(order.begin(), order.end(), allDecks.begin());
+    nextCard = 0;
+    counts.reset(deckCount);
+    drawnCards.clear();
+}
+
+
+/**
+ * Saves the shoe's state. The cards already dealt are part of the order, so they are not
+ * saved separately.
+ * @param snapshot Where to append the state.
+ */
+void MultiDeck::save(SnapshotWriter& snapshot) const
+{
+    snapshot.put(deckCount);
+    snapshot.putBytes(allDecks.data(), allDecks.size() * sizeof(Card));
+    snapshot.put(nextCard);
+    snapshot.put(counts);
+    snapshot.put(antithetic);
+    snapshot.put(mirrorNext);
+    std::ostringstream generator;
+    generator << rng;
+    snapshot.putString(generator.str());
+}
+
+
+/**
+ * Restores a saved state, so the shoe deals exactly as the saved one would have.
+ * @param snapshot Positioned at a save() of a shoe with the same number of decks.
+ * @return False if the snapshot does not hold one.
+ */
+bool MultiDeck::restore(SnapshotReader& snapshot)
+{
+    int decks = 0;
+    std::string generator;
+    if (!snapshot.get(decks) || decks != deckCount
+        || !snapshot.getBytes(allDecks.data(), allDecks.size() * sizeof(Card)) || !snapshot.get(nextCard)
+        || !snapshot.get(counts) || !snapshot.get(antithetic) || !snapshot.get(mirrorNext)
+        || !snapshot.getString(generator) || nextCard < 0 || nextCard > size()) {
+        return false;
+    }
+    std::istringstream input(generator);
+    input >> rng;
+    drawnCards.assign(allDecks.begin(), allDecks.begin() + nextCard);
+    return !input.fail();
+}
+
+
+/**
+ * Changes the number of decks in the shoe, rebuilding and shuffling it if the count changes.
+ * @param decks The new number of decks.
+ */
+void MultiDeck::setDeckCount(int decks)
+{
+    if (decks == deckCount) {
+        return;
+    }
+    deckCount = decks;
+    allDecks.assign(decks * 52, Card());
+    mirrorNext = false;
+    createAndShuffleDecks();
+}
+
+
+/**
+ * Shuffles every card back in except those still in play. Each of them is swapped to the
+ * front of the new order and dealt, so it is counted as seen and cannot be dealt twice; the
+ * cards behind them stay in uniformly random order.
+ * @param inPlay The cards on the table, one entry per physical card.
+ */
+void MultiDeck::shuffleDiscards(const std::vector<Card>& inPlay)
+{
+    createAndShuffleDecks();
+    for (const Card& card : inPlay) {
+        for (int index = nextCard; index < size(); ++index) {
+            if (allDecks[index].name == card.name && allDecks[index].suit == card.suit) {
+                std::swap(allDecks[index], allDecks[nextCard]);
+                drawCard();
+                break;
+            }
+        }
+    }
+}
+
+
+/**
+ * Checks whether the cut card has been reached.
+ * @param penetration Fraction of the shoe to deal before reshuffling.
+ * @return True once at least that fraction of the shoe has been dealt.
+ */
+bool MultiDeck::needsShuffle(double penetration) const
+{
+    return nextCard >= (int) (size() * penetration);
+}
+
+
+/**
+ * Draws a card from the MultiDeck.
+ * @return The drawn Card object.
+ * @throw std::out_of_range if attempting to draw from an empty deck.
+ */
+Card MultiDeck::drawCard()
+{
+    TRACE_SCOPE("draw");
+    if (nextCard == size()) {
+        throw std::out_of_range("Attempted to draw from an empty deck.");
+    }
+
+    Card drawnCard = allDecks[nextCard++];
+    counts.observe(drawnCard.value);
+    drawnCards.push_back(drawnCard);
+    return drawnCard;
+}
@@ -0,0 +1,135 @@
+#include "headers/advisor.h"
+#include "headers/log.h"
+#include "headers/metrics.h"
+#include "headers/trace.h"
+
+/**
+ * @file advisor.cpp
+ * @brief Worker loop of the Advisor.
+ */
+
+
+namespace {
+
+/// Past this many memoized results an analyzer starts afresh, which bounds memory over a
+/// long session at the cost of one slower answer.
+constexpr std::size_t ANALYZER_MEMO_LIMIT = 1u << 20;
+
+/// Past this many entries the answer cache is dropped.
+constexpr std::size_t ANSWER_CACHE_LIMIT = 1u << 16;
+
+} // namespace
+
+
+CompositionKey AdvisorQuery::key() const {
+    int hardTotal = 0;
+    bool hasAce = false;
+    for (int i = 0; i < count; ++i) {
+        hardTotal += rankValue(ranks[i]);
+        hasAce = hasAce || ranks[i] == 0;
+    }
+    // Two-card hands also depend on whether they are a pair, and split aces on being aces.
+    int pairRank = count == 2 && ranks[0] == ranks[1] ? ranks[0] + 1 : 0;
+    bool splitAces = fromSplit && count > 0 && ranks[0] == 0;
+    std::uint32_t state = std::uint32_t(upcard) << 16 | std::uint32_t(pairRank) << 12 | std::uint32_t(hardTotal) << 4
+        | std::uint32_t(hasAce) << 3 | std::uint32_t(count == 2) << 2 | std::uint32_t(fromSplit) << 1
+        | std::uint32_t(splitAces);
+    return CompositionKey{shoe.key(), state};
+}
+
+
+Advisor::Advisor(const RuleSet& rules, Callback ready) : rules(rules), ready(std::move(ready)) {
+    worker = std::thread(&Advisor::run, this);
+}
+
+
+Advisor::~Advisor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        hasPending = false;
+        cancelled.store(true, std::memory_order_relaxed);
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+
+bool Advisor::lookup(const AdvisorQuery& query, ActionValues& values) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = cache.find(query.key());
+    if (found == cache.end()) {
+        return false;
+    }
+    values = found->second;
+    return true;
+}
+
+
+void Advisor::request(const AdvisorQuery& query) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = query;
+        hasPending = true;
+        cancelled.store(true, std::memory_order_relaxed); // under the lock, so the worker cannot have taken this query yet
+    }
+    wake.notify_one();
+}
+
+
+void Advisor::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        hasPending = false;
+        cancelled.store(true, std::memory_order_relaxed);
+    }
+}
+
+
+void Advisor::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [&] { return stopping || hasPending; });
+        if (stopping) {
+            return;
+        }
+        AdvisorQuery query = pending;
+        hasPending = false;
+        cancelled.store(false, std::memory_order_relaxed);
+        lock.unlock();
+
+        std::unique_ptr<HandAnalyzer>& analyzer = analyzers[query.upcard];
+        if (!analyzer) {
+            analyzer.reset(new HandAnalyzer(rules, query.upcard));
+            analyzer->setCancelFlag(&cancelled);
+        } else if (analyzer->size() > ANALYZER_MEMO_LIMIT) {
+            analyzer->clear();
+        }
+
+        bool finished = false;
+        ActionValues values;
+        try {
+            TRACE_SCOPE("Advisor::evaluate");
+            METRICS_TIME(metrics::adviceLatency);
+            values = analyzer->evaluate(query.shoe, query.ranks, query.count, query.fromSplit);
+            finished = true;
+        } catch (const AnalysisCancelled&) {
+            LOG_DEBUG("Advice for a %d-card hand cancelled", query.count);
+        } catch (const std::out_of_range&) {
+            LOG_WARN("Advice unavailable: the shoe is too short to play the hand out");
+        }
+
+        lock.lock();
+        if (finished) {
+            if (cache.size() > ANSWER_CACHE_LIMIT) {
+                cache.clear();
+            }
+            cache[query.key()] = values;
+        }
+        if (finished && !hasPending && !stopping) {
+            lock.unlock();
+            ready(query, values);
+            lock.lock();
+        }
+    }
+}
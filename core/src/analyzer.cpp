@@ -0,0 +1,330 @@
+#include "headers/analyzer.h"
+#include "headers/trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/**
+ * @file analyzer.cpp
+ * @brief Recursive enumeration of player draws for the combinatorial analyzer.
+ *
+ * Every function takes the shoe by reference, removes a card, recurses and puts the card
+ * back, so the shoe always describes exactly the cards the player has not seen. The memo
+ * key is the shoe plus the hand's hard total and ace flag; the total is needed because a
+ * split hand and the unsplit pair leave the same cards in the shoe.
+ */
+
+
+namespace {
+
+enum MemoKind : std::uint32_t { MEMO_HIT = 1, MEMO_DOUBLE = 2, MEMO_SPLIT = 3 };
+
+/// The dealer cache is only a speed-up; past this size it is dropped and rebuilt.
+constexpr std::size_t DEALER_CACHE_LIMIT = 1u << 18;
+
+std::uint32_t memoState(MemoKind kind, int value, bool hasAce) {
+    return std::uint32_t(kind) << 8 | std::uint32_t(value) << 1 | std::uint32_t(hasAce);
+}
+
+/// Best total of a hand given its hard total.
+int bestTotal(int hardTotal, bool hasAce) {
+    return hasAce && hardTotal <= 11 ? hardTotal + 10 : hardTotal;
+}
+
+} // namespace
+
+
+Action ActionValues::best() const {
+    Action action = stand >= hit ? ACTION_STAND : ACTION_HIT;
+    double value = std::max(stand, hit);
+    if (canDouble && doubleDown > value) {
+        action = ACTION_DOUBLE;
+        value = doubleDown;
+    }
+    if (canSplit && split > value) {
+        action = ACTION_SPLIT;
+        value = split;
+    }
+    if (canSurrender && surrender > value) {
+        action = ACTION_SURRENDER;
+    }
+    return action;
+}
+
+
+double ActionValues::bestValue() const {
+    switch (best()) {
+    case ACTION_STAND: return stand;
+    case ACTION_HIT: return hit;
+    case ACTION_DOUBLE: return doubleDown;
+    case ACTION_SPLIT: return split;
+    default: return surrender;
+    }
+}
+
+
+HandAnalyzer::HandAnalyzer(const RuleSet& rules, int upcard)
+    : rules(rules), dealerUpcard(upcard),
+      peeked(rules.dealerPeek && (upcard == 0 || upcard == RANKS - 1)),
+      dealer(rules.hitSoft17) {}
+
+
+double HandAnalyzer::dealerBlackjackChance(const ShoeComposition& shoe) const {
+    if (dealerUpcard == 0) {
+        return shoe.probability(RANKS - 1);
+    }
+    return dealerUpcard == RANKS - 1 ? shoe.probability(0) : 0.0;
+}
+
+
+ActionValues HandAnalyzer::evaluate(const ShoeComposition& shoe, const int *ranks, int count, bool fromSplit) {
+    TRACE_SCOPE("evaluateActions");
+    int hardTotal = 0;
+    bool hasAce = false;
+    for (int i = 0; i < count; ++i) {
+        hardTotal += rankValue(ranks[i]);
+        hasAce = hasAce || ranks[i] == 0;
+    }
+
+    ShoeComposition rest = shoe;
+    ActionValues values;
+    bool splitAces = fromSplit && ranks[0] == 0 && !rules.hitSplitAces;
+    values.stand = stand(rest, hardTotal, hasAce);
+    values.hit = splitAces ? values.stand : hit(rest, hardTotal, hasAce); // split aces may only stand
+    values.canDouble = count == 2 && !splitAces && (!fromSplit || rules.doubleAfterSplit);
+    if (values.canDouble) {
+        values.doubleDown = doubleDown(rest, hardTotal, hasAce);
+    }
+    values.canSplit = count == 2 && !fromSplit && ranks[0] == ranks[1] && rules.maxSplitHands >= 2;
+    if (values.canSplit) {
+        values.split = 2.0 * splitHand(rest, ranks[0]);
+    }
+    values.canSurrender = count == 2 && !fromSplit && rules.surrender != SURRENDER_NONE;
+    return values;
+}
+
+
+double HandAnalyzer::initialHandValue(const ShoeComposition& shoe, int first, int second) {
+    double dealerBlackjack = dealerBlackjackChance(shoe);
+    if ((first == 0 && second == RANKS - 1) || (first == RANKS - 1 && second == 0)) {
+        return (1.0 - dealerBlackjack) * rules.blackjackPayout(); // a dealer blackjack pushes
+    }
+
+    int ranks[2] = { first, second };
+    double value = evaluate(shoe, ranks, 2).bestValue();
+    if (peeked) {
+        value = -dealerBlackjack + (1.0 - dealerBlackjack) * value;
+    }
+    if (rules.surrender == SURRENDER_EARLY) {
+        value = std::max(value, -0.5);
+    }
+    return value;
+}
+
+
+double HandAnalyzer::upcardValue(const ShoeComposition& shoe) {
+    TRACE_SCOPE("upcardValue");
+    ShoeComposition rest = shoe;
+    double total = 0.0;
+    for (int first = 0; first < RANKS; ++first) {
+        if (rest.counts[first] == 0) {
+            continue;
+        }
+        double firstChance = rest.probability(first);
+        rest.remove(first);
+        for (int second = first; second < RANKS; ++second) {
+            if (rest.counts[second] == 0) {
+                continue;
+            }
+            double chance = firstChance * rest.probability(second) * (first == second ? 1.0 : 2.0);
+            rest.remove(second);
+            total += chance * initialHandValue(rest, first, second);
+            rest.add(second);
+        }
+        rest.add(first);
+    }
+    return total;
+}
+
+
+double HandAnalyzer::stand(ShoeComposition& shoe, int hardTotal, bool hasAce) {
+    DealerOutcome outcome = dealer.outcome(shoe, dealerUpcard, peeked);
+    if (dealer.size() > DEALER_CACHE_LIMIT) {
+        dealer.clear();
+    }
+
+    int total = bestTotal(hardTotal, hasAce);
+    double value = outcome.probability[DEALER_BUST] - outcome.probability[DEALER_BLACKJACK];
+    for (int dealerTotal = 17; dealerTotal <= 21; ++dealerTotal) {
+        double chance = outcome.probability[DEALER_17 + dealerTotal - 17];
+        value += total > dealerTotal ? chance : (total < dealerTotal ? -chance : 0.0);
+    }
+    return value;
+}
+
+
+void HandAnalyzer::checkCancelled() const {
+    if (cancelFlag && cancelFlag->load(std::memory_order_relaxed)) {
+        throw AnalysisCancelled();
+    }
+}
+
+
+/// Expected value of taking one card and then playing on as well as possible.
+double HandAnalyzer::hit(ShoeComposition& shoe, int hardTotal, bool hasAce) {
+    CompositionKey key{shoe.key(), memoState(MEMO_HIT, hardTotal, hasAce)};
+    auto found = memo.find(key);
+    if (found != memo.end()) {
+        return found->second;
+    }
+    checkCancelled();
+
+    double value = 0.0;
+    for (int rank = 0; rank < RANKS; ++rank) {
+        if (shoe.counts[rank] == 0) {
+            continue;
+        }
+        double chance = shoe.probability(rank);
+        int newTotal = hardTotal + rankValue(rank);
+        bool newAce = hasAce || rank == 0;
+        if (bestTotal(newTotal, newAce) > 21) {
+            value -= chance;
+            continue;
+        }
+        shoe.remove(rank);
+        value += chance * bestHitOrStand(shoe, newTotal, newAce);
+        shoe.add(rank);
+    }
+    memo[key] = value;
+    return value;
+}
+
+
+double HandAnalyzer::bestHitOrStand(ShoeComposition& shoe, int hardTotal, bool hasAce) {
+    double standValue = stand(shoe, hardTotal, hasAce);
+    if (bestTotal(hardTotal, hasAce) == 21) {
+        return standValue;
+    }
+    return std::max(standValue, hit(shoe, hardTotal, hasAce));
+}
+
+
+/// Expected value, in original bets, of doubling and standing on the one card drawn.
+double HandAnalyzer::doubleDown(ShoeComposition& shoe, int hardTotal, bool hasAce) {
+    CompositionKey key{shoe.key(), memoState(MEMO_DOUBLE, hardTotal, hasAce)};
+    auto found = memo.find(key);
+    if (found != memo.end()) {
+        return found->second;
+    }
+
+    double value = 0.0;
+    for (int rank = 0; rank < RANKS; ++rank) {
+        if (shoe.counts[rank] == 0) {
+            continue;
+        }
+        double chance = shoe.probability(rank);
+        int newTotal = hardTotal + rankValue(rank);
+        bool newAce = hasAce || rank == 0;
+        if (bestTotal(newTotal, newAce) > 21) {
+            value -= chance;
+            continue;
+        }
+        shoe.remove(rank);
+        value += chance * stand(shoe, newTotal, newAce);
+        shoe.add(rank);
+    }
+    memo[key] = 2.0 * value;
+    return 2.0 * value;
+}
+
+
+/**
+ * @brief Expected value of one hand after splitting a pair.
+ * @param shoe Cards left to draw, with both cards of the pair already removed.
+ * @param pairRank Rank index of the pair.
+ */
+double HandAnalyzer::splitHand(ShoeComposition& shoe, int pairRank) {
+    CompositionKey key{shoe.key(), memoState(MEMO_SPLIT, pairRank, false)};
+    auto found = memo.find(key);
+    if (found != memo.end()) {
+        return found->second;
+    }
+    checkCancelled();
+
+    double value = 0.0;
+    for (int rank = 0; rank < RANKS; ++rank) {
+        if (shoe.counts[rank] == 0) {
+            continue;
+        }
+        double chance = shoe.probability(rank);
+        int hardTotal = rankValue(pairRank) + rankValue(rank);
+        bool hasAce = pairRank == 0 || rank == 0;
+        shoe.remove(rank);
+        double best = stand(shoe, hardTotal, hasAce);
+        bool drawsOne = pairRank == 0 && !rules.hitSplitAces;
+        if (!drawsOne && bestTotal(hardTotal, hasAce) < 21) {
+            best = std::max(best, hit(shoe, hardTotal, hasAce));
+            if (rules.doubleAfterSplit) {
+                best = std::max(best, doubleDown(shoe, hardTotal, hasAce));
+            }
+        }
+        value += chance * best;
+        shoe.add(rank);
+    }
+    memo[key] = value;
+    return value;
+}
+
+
+AnalysisReport analyzeShoe(const RuleSet& rules, const ShoeComposition& shoe, int threads) {
+    AnalysisReport report;
+    std::atomic<int> nextUpcard(0);
+
+    auto work = [&]() {
+        for (int upcard = nextUpcard++; upcard < RANKS; upcard = nextUpcard++) {
+            if (shoe.counts[upcard] == 0) {
+                continue;
+            }
+            ShoeComposition rest = shoe;
+            rest.remove(upcard);
+            HandAnalyzer analyzer(rules, upcard);
+            for (int first = 0; first < RANKS; ++first) {
+                for (int second = first; second < RANKS; ++second) {
+                    ShoeComposition left = rest;
+                    if (left.counts[first] == 0) {
+                        continue;
+                    }
+                    left.remove(first);
+                    if (left.counts[second] == 0) {
+                        continue;
+                    }
+                    left.remove(second);
+                    int ranks[2] = { first, second };
+                    report.hands[upcard][first][second] = analyzer.evaluate(left, ranks, 2);
+                    report.initialValue[upcard][first][second] = analyzer.initialHandValue(left, first, second);
+                }
+            }
+            report.upcardValue[upcard] = analyzer.upcardValue(rest);
+        }
+    };
+
+    if (threads <= 0) {
+        threads = (int) std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, RANKS);
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (int upcard = 0; upcard < RANKS; ++upcard) {
+        report.expectedValue += shoe.probability(upcard) * report.upcardValue[upcard];
+    }
+    return report;
+}
@@ -0,0 +1,208 @@
+#include "headers/betting.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+/**
+ * @file betting.cpp
+ * @brief Bet ramps and the statistics derived from binned results.
+ */
+
+
+namespace {
+
+double clampBet(double bet, double minBet, double maxBet) {
+    return bet < minBet ? minBet : (bet > maxBet ? maxBet : bet);
+}
+
+/// Typical effect of removing one card of each value (ace first) per deck, in percent of
+/// the bet; the exact figures for a table come from removal.h.
+constexpr double TYPICAL_EFFECTS[TAGGED_VALUES] = {
+    -0.61, 0.38, 0.44, 0.55, 0.69, 0.46, 0.28, 0.00, -0.18, -0.51
+};
+
+/// Slope of TYPICAL_EFFECTS against a system's tags, over the cards of a deck.
+double effectSlope(CountingSystem system) {
+    double covariance = 0.0;
+    double variance = 0.0;
+    for (int value = 0; value < TAGGED_VALUES; ++value) {
+        double cards = value == TAGGED_VALUES - 1 ? 16.0 : 4.0;
+        double tag = COUNTING_TAGS[system].tags[value];
+        covariance += cards * tag * TYPICAL_EFFECTS[value];
+        variance += cards * tag * tag;
+    }
+    return covariance / variance;
+}
+
+} // namespace
+
+
+/**
+ * @brief The bet for the next round.
+ * @param trueCount True count before the round is dealt.
+ * @return Bet in units.
+ */
+double BetRamp::bet(double trueCount) const {
+    switch (kind) {
+    case RAMP_KELLY: {
+        double edge = baseEdge + edgePerCount * trueCount;
+        return clampBet(kellyFraction * bankroll * edge / variance, minBet, maxBet);
+    }
+    case RAMP_TABLE:
+        return tableBets[countBin(trueCount)];
+    default:
+        return clampBet(step * (std::floor(trueCount) - pivot + 1), minBet, maxBet);
+    }
+}
+
+
+bool BetRamp::setCountingSystem(CountingSystem system) {
+    if (deckTagSum(system) != 0) {
+        return kind != RAMP_KELLY;
+    }
+    edgePerCount = edgePerTrueCount(system);
+    return true;
+}
+
+
+double BetRamp::bet(double trueCount, double balance) const {
+    if (kind != RAMP_KELLY) {
+        return bet(trueCount);
+    }
+    double edge = baseEdge + edgePerCount * trueCount;
+    return clampBet(kellyFraction * balance * edge / variance, minBet, maxBet);
+}
+
+
+std::string BetRamp::describe() const {
+    char text[160];
+    switch (kind) {
+    case RAMP_KELLY:
+        if (maxBet == std::numeric_limits<double>::max()) {
+            std::snprintf(text, sizeof text, "kelly %.2f of %.0f units, min %g, no max",
+                          kellyFraction, bankroll, minBet);
+        } else {
+            std::snprintf(text, sizeof text, "kelly %.2f of %.0f units, %g-%g",
+                          kellyFraction, bankroll, minBet, maxBet);
+        }
+        break;
+    case RAMP_TABLE:
+        std::snprintf(text, sizeof text, "table %g-%g", tableBets[0], tableBets[COUNT_BINS - 1]);
+        break;
+    default:
+        std::snprintf(text, sizeof text, "fixed %g-%g, %g per count from %+d", minBet, maxBet, step, pivot);
+        break;
+    }
+    return text;
+}
+
+
+bool parseBetRamp(const char *text, BetRamp& ramp) {
+    BetRamp parsed;
+    if (std::strncmp(text, "fixed:", 6) == 0) {
+        parsed.kind = RAMP_FIXED;
+        int fields = std::sscanf(text + 6, "%lf:%lf:%lf:%d",
+                                 &parsed.minBet, &parsed.maxBet, &parsed.step, &parsed.pivot);
+        if (fields < 2) {
+            return false;
+        }
+        if (fields < 3) {
+            parsed.step = parsed.minBet;
+        }
+    } else if (std::strncmp(text, "kelly:", 6) == 0) {
+        parsed.kind = RAMP_KELLY;
+        parsed.maxBet = std::numeric_limits<double>::max();
+        if (std::sscanf(text + 6, "%lf:%lf:%lf:%lf", &parsed.bankroll, &parsed.kellyFraction, &parsed.minBet,
+                        &parsed.maxBet) < 1 || parsed.bankroll <= 0.0 || parsed.kellyFraction <= 0.0) {
+            return false;
+        }
+    } else if (std::strncmp(text, "table:", 6) == 0) {
+        parsed.kind = RAMP_TABLE;
+        bool listed[COUNT_BINS] = {};
+        const char *entry = text + 6;
+        while (*entry != '\0') {
+            int count;
+            double bet;
+            int length;
+            if (std::sscanf(entry, "%d=%lf%n", &count, &bet, &length) != 2 || bet <= 0.0) {
+                return false;
+            }
+            parsed.tableBets[countBin(count)] = bet;
+            listed[countBin(count)] = true;
+            entry += length;
+            entry += *entry == ',' ? 1 : 0;
+        }
+        // Each bin takes the bet of the nearest listed count at or below it, or the lowest.
+        int first = 0;
+        while (first < COUNT_BINS && !listed[first]) {
+            ++first;
+        }
+        if (first == COUNT_BINS) {
+            return false;
+        }
+        for (int bin = 0; bin < COUNT_BINS; ++bin) {
+            if (!listed[bin]) {
+                parsed.tableBets[bin] = bin < first ? parsed.tableBets[first] : parsed.tableBets[bin - 1];
+            }
+        }
+        parsed.minBet = parsed.tableBets[0];
+        parsed.maxBet = parsed.tableBets[COUNT_BINS - 1];
+    } else {
+        return false;
+    }
+    if (parsed.minBet <= 0.0 || parsed.maxBet < parsed.minBet) {
+        return false;
+    }
+    ramp = parsed;
+    return true;
+}
+
+
+double edgePerTrueCount(CountingSystem system) {
+    return 0.005 * effectSlope(system) / effectSlope(COUNT_HI_LO);
+}
+
+
+void BinStats::merge(const BinStats& other) {
+    rounds += other.rounds;
+    wagered += other.wagered;
+    results.merge(other.results);
+    unitResults.merge(other.unitResults);
+}
+
+
+double BinStats::score() const {
+    double sd = standardDeviation();
+    if (sd <= 0.0 || winRate() <= 0.0) {
+        return 0.0;
+    }
+    double ratio = winRate() / sd;
+    return 1e6 * ratio * ratio;
+}
+
+
+double BinStats::n0() const {
+    if (winRate() <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double ratio = standardDeviation() / winRate();
+    return ratio * ratio;
+}
+
+
+void BettingStats::merge(const BettingStats& other) {
+    for (int bin = 0; bin < COUNT_BINS; ++bin) {
+        bins[bin].merge(other.bins[bin]);
+    }
+}
+
+
+BinStats BettingStats::total() const {
+    BinStats sum;
+    for (const BinStats& bin : bins) {
+        sum.merge(bin);
+    }
+    return sum;
+}
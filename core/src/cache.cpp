@@ -0,0 +1,57 @@
+#include "headers/cache.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <system_error>
+
+/**
+ * @file cache.cpp
+ * @brief Result files on disk.
+ */
+
+
+std::string ResultCache::defaultDirectory() {
+    const char *directory = std::getenv("BJ_CACHE_DIR");
+    return directory && *directory ? directory : ".bjsim-cache";
+}
+
+
+std::string ResultCache::path(const char *kind, std::uint64_t key) const {
+    char name[64];
+    std::snprintf(name, sizeof name, "%s-%016" PRIx64 ".txt", kind, key);
+    return root + "/" + name;
+}
+
+
+bool ResultCache::load(const char *kind, std::uint64_t key, std::string& contents) const {
+    std::FILE *file = std::fopen(path(kind, key).c_str(), "r");
+    if (file == nullptr) {
+        return false;
+    }
+    contents.clear();
+    char buffer[4096];
+    std::size_t read;
+    while ((read = std::fread(buffer, 1, sizeof buffer, file)) > 0) {
+        contents.append(buffer, read);
+    }
+    bool ok = !std::ferror(file);
+    std::fclose(file);
+    return ok;
+}
+
+
+bool ResultCache::store(const char *kind, std::uint64_t key, const std::string& contents) const {
+    std::error_code error;
+    std::filesystem::create_directories(root, error);
+    std::string target = path(kind, key);
+    std::string temporary = target + ".tmp";
+    std::FILE *file = std::fopen(temporary.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    ok = (std::fclose(file) == 0) && ok;
+    return ok && std::rename(temporary.c_str(), target.c_str()) == 0;
+}
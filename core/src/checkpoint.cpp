@@ -0,0 +1,123 @@
+#include "headers/checkpoint.h"
+
+#include <cstdio>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define BJ_CHECKPOINT_HAVE_FSYNC 1
+#endif
+
+/**
+ * @file checkpoint.cpp
+ * @brief Reading and writing checkpoint files.
+ *
+ * A file is the magic number, a format version, the run's fingerprint and the number of
+ * streams, then for each stream a flag and, if it has saved, its state as a string. Where
+ * the platform has fsync() the new file is flushed to disk before it replaces the old one,
+ * so a checkpoint also survives the machine going down.
+ */
+
+
+namespace {
+
+constexpr std::uint32_t CHECKPOINT_MAGIC = 0x4b434a42; /// "BJCK" in little-endian order.
+constexpr std::uint32_t CHECKPOINT_VERSION = 1;
+
+} // namespace
+
+
+CheckpointFile::CheckpointFile(std::string path, std::uint64_t fingerprint, int streams,
+                               std::chrono::milliseconds interval)
+    : file(std::move(path)), fingerprint(fingerprint), interval(interval), states(streams), saved(streams, false),
+      next(streams, std::chrono::steady_clock::now() + interval) {}
+
+
+bool CheckpointFile::load() {
+    std::FILE *input = std::fopen(file.c_str(), "rb");
+    if (input == nullptr) {
+        return false;
+    }
+    std::string bytes;
+    char buffer[65536];
+    std::size_t read;
+    while ((read = std::fread(buffer, 1, sizeof buffer, input)) > 0) {
+        bytes.append(buffer, read);
+    }
+    std::fclose(input);
+
+    SnapshotReader reader(bytes);
+    std::uint32_t magic = 0;
+    std::uint32_t version = 0;
+    std::uint64_t storedFingerprint = 0;
+    std::uint32_t streams = 0;
+    if (!reader.get(magic) || !reader.get(version) || !reader.get(storedFingerprint) || !reader.get(streams)
+        || magic != CHECKPOINT_MAGIC || version != CHECKPOINT_VERSION || storedFingerprint != fingerprint
+        || streams != states.size()) {
+        return false;
+    }
+    std::vector<std::string> loaded(streams);
+    std::vector<bool> present(streams, false);
+    for (std::uint32_t stream = 0; stream < streams; ++stream) {
+        std::uint8_t flag = 0;
+        if (!reader.get(flag) || (flag && !reader.getString(loaded[stream]))) {
+            return false;
+        }
+        present[stream] = flag != 0;
+    }
+    if (!reader.atEnd()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    states.swap(loaded);
+    saved.swap(present);
+    return true;
+}
+
+
+const std::string *CheckpointFile::state(int stream) const {
+    return saved[stream] ? &states[stream] : nullptr;
+}
+
+
+bool CheckpointFile::save(int stream, std::string state) {
+    std::lock_guard<std::mutex> lock(mutex);
+    states[stream] = std::move(state);
+    saved[stream] = true;
+    next[stream] = std::chrono::steady_clock::now() + interval;
+    return write();
+}
+
+
+void CheckpointFile::remove() {
+    std::remove(file.c_str());
+}
+
+
+bool CheckpointFile::write() const {
+    SnapshotWriter writer;
+    writer.put(CHECKPOINT_MAGIC);
+    writer.put(CHECKPOINT_VERSION);
+    writer.put(fingerprint);
+    writer.put<std::uint32_t>((std::uint32_t) states.size());
+    for (std::size_t stream = 0; stream < states.size(); ++stream) {
+        writer.put<std::uint8_t>(saved[stream] ? 1 : 0);
+        if (saved[stream]) {
+            writer.putString(states[stream]);
+        }
+    }
+
+    std::string temporary = file + ".tmp";
+    std::FILE *output = std::fopen(temporary.c_str(), "wb");
+    if (output == nullptr) {
+        return false;
+    }
+    const std::string& bytes = writer.data();
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), output) == bytes.size();
+    ok = std::fflush(output) == 0 && ok;
+#ifdef BJ_CHECKPOINT_HAVE_FSYNC
+    ok = fsync(fileno(output)) == 0 && ok;
+#endif
+    ok = (std::fclose(output) == 0) && ok;
+    return ok && std::rename(temporary.c_str(), file.c_str()) == 0;
+}
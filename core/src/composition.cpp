@@ -0,0 +1,26 @@
+#include "headers/composition.h"
+
+/**
+ * @file composition.cpp
+ * @brief Building shoe compositions from deck counts and from a live shoe.
+ */
+
+
+ShoeComposition ShoeComposition::fullShoe(int decks) {
+    ShoeComposition shoe;
+    for (int rank = 0; rank < RANKS - 1; ++rank) {
+        shoe.counts[rank] = 4 * decks;
+    }
+    shoe.counts[RANKS - 1] = 16 * decks;
+    shoe.total = 52 * decks;
+    return shoe;
+}
+
+
+ShoeComposition ShoeComposition::remainingIn(const MultiDeck& shoe) {
+    ShoeComposition composition;
+    for (int i = shoe.nextCard; i < shoe.size(); ++i) {
+        composition.add(rankIndex(shoe.allDecks[i]));
+    }
+    return composition;
+}
@@ -0,0 +1,153 @@
+
+#include <cstdlib>
+#include <ctime>
+
+#include "headers/dealer.h"
+#include "headers/log.h"
+#include "headers/trace.h"
+
+/**
+ * @file dealer.cpp
+ * @brief Implementation of the dealer class.
+ *
+ * Defines the actions and behaviors of the dealer in a card game, including dealing cards,
+ * hitting, and evaluating hands.
+ *
+ * @author Hsiao Yuan Lu
+ */
+
+
+/**
+ * @brief Adds a card to the dealer's hand from the deck.
+ *
+ * This function draws a card from the deck and adds it to the dealer's hand.
+ * It checks if the deck is not null before attempting to draw a card.
+ */
+void dealer::Hit() {
+    if (deck != nullptr) { // Check if the deck pointer is not null
+        Card newCard = deck->drawCard(); // Use the drawCard() method
+        hand.push_back(newCard); // Add the drawn card to the hand
+    }
+}
+
+/**
+ * @brief Deals a card to a player.
+ * @param player Reference to the player object receiving the card.
+ *
+ * This method delegates the card drawing to the player's Hit function.
+ */
+void dealer::dealCardToPlayer(player& player) {
+    if (deck != nullptr) {
+        player.Hit(); // Add the card to the player's hand
+    }
+}
+
+
+
+/**
+ * @brief Evaluates the dealer's hand and calculates the possible scores.
+ * @return A pair containing the minimum and maximum possible scores of the hand.
+ *
+ * This function calculates the total score of the dealer's hand considering the dual
+ * value of aces. It returns both the minimum and maximum scores as a pair.
+ */
+std::pair<int, int> dealer::CheckHand() {
+    int minSum = 0;
+    int maxSum = 0;
+
+    for (size_t i = 0; i < hand.size(); ++i) {
+        // Access and use 'hand[i]'
+
+        if(hand[i].isAce()){
+            minSum += hand[i].value;
+            maxSum = minSum + 10;
+        }
+        else{
+            minSum += hand[i].value;
+            maxSum += hand[i].value;
+        }
+
+    }
+
+    return std::make_pair(minSum, maxSum);
+}
+
+
+/**
+ * @brief Plays out the dealer's hand according to the game rules.
+ * @param hitSoft17 True if the dealer hits soft 17 (H17), false to stand on all 17s (S17).
+ * @return The dealer's final hand value.
+ *
+ * The dealer will continue to hit until the hand's value is 17 or higher, and also on a
+ * soft 17 under H17 rules. The returned value tells whether the dealer stood or busted and
+ * on which total.
+ */
+HandValue dealer::PlayHand(bool hitSoft17) {
+    TRACE_SCOPE("dealerPlay");
+    HandValue handValue = GetHandValue();
+
+    while (handValue.total < 17 || (hitSoft17 && handValue.soft && handValue.total == 17)) {
+        Hit();
+        handValue = GetHandValue();
+    }
+
+    return handValue;
+}
+
+
+/**
+ * @brief Logs the dealer's entire hand and its value.
+ *
+ * Writes the hand value, noting when an ace is still being counted as 11, followed by the
+ * value of each card. Only produces output in builds with debug logging enabled.
+ */
+void dealer::revealHand() {
+    HandValue handValue = GetHandValue();
+    LOG_DEBUG("Dealer hand value: %d%s", handValue.total, handValue.soft ? " (soft)" : "");
+
+    for (size_t i = 0; i < hand.size(); ++i) {
+        LOG_DEBUG("    card %zu: value %d, suit %d", i, hand[i].value, (int) hand[i].suit);
+    }
+}
+
+
+/**
+ * @brief Compares the dealer's hand with one of a player's hands to determine the outcome.
+ * @param playerHand The player's hand to compare with.
+ * @return OUTCOME_LOSE (0) if the dealer wins, OUTCOME_WIN (1) if the player wins, OUTCOME_PUSH (2) for a tie.
+ *
+ * This function compares the hands of the dealer and a player to decide the winner.
+ * It accounts for scenarios like busts and ties, and a blackjack beats any other 21.
+ * A 21 made on a split hand is not a blackjack.
+ */
+HandOutcome dealer::CompareHands(const Hand& playerHand) {
+    bool dealerBlackjack = HasBlackjack();
+    bool playerBlackjack = playerHand.isNatural();
+    if (dealerBlackjack != playerBlackjack) {
+        return playerBlackjack ? OUTCOME_WIN : OUTCOME_LOSE;
+    }
+    return compareHandValues(GetHandValue(), playerHand.value());
+}
+
+
+/**
+ * @brief Evaluates the dealer's hand without building any strings.
+ * @return A HandValue holding the best total and the bust and soft flags.
+ */
+HandValue dealer::GetHandValue() const {
+    return evaluateHand(hand);
+}
+
+
+/**
+ * @brief Returns the value of the dealer's face up card.
+ * @return The value of the second card in the hand, counting an ace as 11.
+ *
+ * This is what the player can see of the dealer's hand after the initial deal.
+ */
+int dealer::GetUpcardValue() const {
+    if (hand[1].isAce()) {
+        return 11;
+    }
+    return hand[1].value;
+}
@@ -0,0 +1,158 @@
+#include "headers/dealerprob.h"
+#include "headers/trace.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @file dealerprob.cpp
+ * @brief Enumeration of the dealer's draws.
+ *
+ * The dealer's hand is fully described by the multiset of cards drawn, so the draw list is
+ * built one card at a time over multisets, adding up the number of orders that reach each
+ * one while the hand is still drawing. Drawing a particular order of k cards with k_r of
+ * rank r from a shoe of N cards with c_r of rank r has chance
+ * prod_r c_r (c_r - 1) ... (c_r - k_r + 1) / N (N - 1) ... (N - k + 1),
+ * which is what outcome() sums.
+ */
+
+
+namespace {
+
+constexpr std::uint32_t TOP_LEVEL = 1u << 16; /// Tags cached outcome() answers.
+
+/// A hand still drawing has a hard total of 16 at most, so the dealer never draws more.
+constexpr int MAX_DEALER_CARDS = 16;
+
+/// Rank index of the hole card that gives the dealer blackjack, or -1 if none can.
+int blackjackHoleFor(int upcard) {
+    return upcard == 0 ? RANKS - 1 : (upcard == RANKS - 1 ? 0 : -1);
+}
+
+} // namespace
+
+
+const DealerOutcome& DealerProbabilities::outcome(const ShoeComposition& shoe, int upcard, bool peeked) {
+    CompositionKey key{shoe.key(), TOP_LEVEL | std::uint32_t(upcard) << 1 | std::uint32_t(peeked)};
+    auto found = cache.find(key);
+    if (found != cache.end()) {
+        return found->second;
+    }
+    TRACE_SCOPE("dealerOutcome");
+
+    // Under a peek the hole card cannot complete a blackjack, so those cards are left out.
+    int blackjackHole = blackjackHoleFor(upcard);
+    int holeCards = shoe.total;
+    if (peeked && blackjackHole >= 0) {
+        holeCards -= shoe.counts[blackjackHole];
+    }
+    if (holeCards <= 0) {
+        throw std::out_of_range("no cards left for the dealer's hole card");
+    }
+
+    // Falling factorials of each rank count and of the shoe size.
+    double rankFalling[RANKS][MAX_DEALER_CARDS + 1];
+    double shoeFalling[MAX_DEALER_CARDS + 1];
+    for (int rank = 0; rank < RANKS; ++rank) {
+        rankFalling[rank][0] = 1.0;
+        for (int taken = 1; taken <= MAX_DEALER_CARDS; ++taken) {
+            rankFalling[rank][taken] = rankFalling[rank][taken - 1] * std::max(shoe.counts[rank] - taken + 1, 0);
+        }
+    }
+    shoeFalling[0] = 1.0;
+    for (int taken = 1; taken <= MAX_DEALER_CARDS; ++taken) {
+        shoeFalling[taken] = shoeFalling[taken - 1] * std::max(shoe.total - taken + 1, 0);
+    }
+
+    // Sets with the same card count share a denominator, so it is divided out once per count.
+    double sums[DEALER_RESULTS][MAX_DEALER_CARDS + 1] = {};
+    for (const DrawnCards& drawn : drawsFor(upcard)) {
+        if (peeked && drawn.result == DEALER_BLACKJACK) {
+            continue;
+        }
+        double chance = drawn.orderings;
+        for (int i = 0; i < drawn.distinct; ++i) {
+            chance *= rankFalling[drawn.ranks[i]][drawn.taken[i]];
+        }
+        sums[drawn.result][drawn.cards] += chance;
+    }
+
+    DealerOutcome result;
+    for (int cards = 1; cards <= MAX_DEALER_CARDS && shoeFalling[cards] > 0.0; ++cards) {
+        for (int i = 0; i < DEALER_RESULTS; ++i) {
+            result.probability[i] += sums[i][cards] / shoeFalling[cards];
+        }
+    }
+    if (peeked && blackjackHole >= 0) {
+        double scale = double(shoe.total) / holeCards;
+        for (int i = 0; i < DEALER_RESULTS; ++i) {
+            result.probability[i] *= scale;
+        }
+    }
+    return cache[key] = result;
+}
+
+
+/// Every set of cards the dealer can finish with behind an upcard, built on first use.
+const std::vector<DealerProbabilities::DrawnCards>& DealerProbabilities::drawsFor(int upcard) {
+    std::vector<DrawnCards>& list = draws[upcard];
+    if (!list.empty()) {
+        return list;
+    }
+
+    struct Partial {
+        unsigned char counts[RANKS];
+        unsigned char cards;
+        double orderings;
+    };
+
+    int blackjackHole = blackjackHoleFor(upcard);
+    std::vector<Partial> drawing(1, Partial{{}, 0, 1.0});
+    while (!drawing.empty()) {
+        // Every multiset one card larger than a hand still drawing, with its orderings.
+        std::unordered_map<std::uint64_t, Partial> next;
+        for (const Partial& hand : drawing) {
+            for (int rank = 0; rank < RANKS; ++rank) {
+                Partial more = hand;
+                ++more.counts[rank];
+                ++more.cards;
+                ShoeComposition packed;
+                std::copy(more.counts, more.counts + RANKS, packed.counts);
+                auto inserted = next.emplace(packed.key(), more);
+                if (!inserted.second) {
+                    inserted.first->second.orderings += hand.orderings;
+                }
+            }
+        }
+
+        drawing.clear();
+        for (auto& entry : next) {
+            const Partial& hand = entry.second;
+            int hardTotal = rankValue(upcard);
+            for (int rank = 0; rank < RANKS; ++rank) {
+                hardTotal += hand.counts[rank] * rankValue(rank);
+            }
+            bool soft = (upcard == 0 || hand.counts[0] > 0) && hardTotal <= 11;
+            int total = soft ? hardTotal + 10 : hardTotal;
+            DrawnCards drawn{{}, {}, 0, hand.cards, 0, hand.orderings};
+            if (hand.cards == 1 && blackjackHole >= 0 && hand.counts[blackjackHole] == 1) {
+                drawn.result = DEALER_BLACKJACK;
+            } else if (total > 21) {
+                drawn.result = DEALER_BUST;
+            } else if (total >= 17 && !(hitSoft17 && soft && total == 17)) {
+                drawn.result = DEALER_17 + total - 17;
+            } else {
+                drawing.push_back(hand);
+                continue;
+            }
+            for (int rank = 0; rank < RANKS; ++rank) {
+                if (hand.counts[rank] > 0) {
+                    drawn.ranks[drawn.distinct] = rank;
+                    drawn.taken[drawn.distinct++] = hand.counts[rank];
+                }
+            }
+            list.push_back(drawn);
+        }
+    }
+    return list;
+}
@@ -0,0 +1,160 @@
+#include "headers/deviations.h"
+#include "headers/strategy.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @file deviations.cpp
+ * @brief Reading and writing IndexTable files.
+ */
+
+
+namespace {
+
+const char *const ACTION_NAMES[ACTION_KINDS] = {"stand", "hit", "double", "split", "surrender"};
+
+} // namespace
+
+
+std::string strategyRowName(int row) {
+    if (row >= pairRow(2)) {
+        return "pair" + std::to_string(row - pairRow(0));
+    } else if (row >= softRow(12)) {
+        return "soft" + std::to_string(row - softRow(0));
+    }
+    return "hard" + std::to_string(row - hardRow(0));
+}
+
+
+bool parseStrategyRow(const char *name, int& row) {
+    char *end = nullptr;
+    if (std::strncmp(name, "hard", 4) == 0) {
+        long total = std::strtol(name + 4, &end, 10);
+        row = hardRow((int) total);
+        return *end == '\0' && total >= 4 && total <= 21;
+    } else if (std::strncmp(name, "soft", 4) == 0) {
+        long total = std::strtol(name + 4, &end, 10);
+        row = softRow((int) total);
+        return *end == '\0' && total >= 12 && total <= 21;
+    } else if (std::strncmp(name, "pair", 4) == 0) {
+        long value = std::strtol(name + 4, &end, 10);
+        row = pairRow((int) value);
+        return *end == '\0' && value >= 2 && value <= 11;
+    }
+    return false;
+}
+
+
+const char *actionName(Action action) {
+    return ACTION_NAMES[action];
+}
+
+
+bool parseAction(const char *name, Action& action) {
+    for (int index = 0; index < ACTION_KINDS; ++index) {
+        if (std::strcmp(name, ACTION_NAMES[index]) == 0) {
+            action = Action(index);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool IndexTable::load(const std::string& path) {
+    std::FILE *file = std::fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return false;
+    }
+    IndexTable loaded;
+    bool ok = true;
+    char line[256];
+    while (ok && std::fgets(line, sizeof line, file)) {
+        char *comment = std::strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        char word[32], rowText[32], actionText[32], side[4];
+        int upcard = 0;
+        double index = 0.0;
+        if (std::sscanf(line, " %31s", word) != 1) {
+            continue; // blank
+        } else if (std::strcmp(word, "count") == 0) {
+            ok = std::sscanf(line, " count %31s", word) == 1 && parseCountingSystem(word, loaded.system);
+        } else if (std::strcmp(word, "insurance") == 0) {
+            ok = std::sscanf(line, " insurance %lf", &loaded.insuranceIndex) == 1;
+            loaded.insures = ok;
+        } else if (std::strcmp(word, "play") == 0) {
+            Deviation play;
+            ok = std::sscanf(line, " play %31s %d %31s %3s %lf", rowText, &upcard, actionText, side, &index) == 5
+                && parseStrategyRow(rowText, play.row) && upcard >= 2 && upcard <= 11
+                && parseAction(actionText, play.action)
+                && (std::strcmp(side, ">=") == 0 || std::strcmp(side, "<=") == 0);
+            play.upcard = upcard;
+            play.index = index;
+            play.atOrAbove = side[0] == '>';
+            if (ok) {
+                loaded.plays.push_back(play);
+            }
+        } else {
+            ok = false;
+        }
+    }
+    std::fclose(file);
+    if (ok) {
+        *this = loaded;
+    }
+    return ok;
+}
+
+
+std::string IndexTable::format() const {
+    std::string out = "count ";
+    out += COUNTING_TAGS[system].option;
+    out += '\n';
+    char line[128];
+    if (insures) {
+        std::snprintf(line, sizeof line, "insurance %.1f\n", insuranceIndex);
+        out += line;
+    }
+    for (const Deviation& play : plays) {
+        std::snprintf(line, sizeof line, "play %s %d %s %s %.1f\n", strategyRowName(play.row).c_str(), play.upcard,
+                      actionName(play.action), play.atOrAbove ? ">=" : "<=", play.index);
+        out += line;
+    }
+    return out;
+}
+
+
+bool IndexTable::save(const std::string& path, const std::string& comment) const {
+    std::string contents;
+    std::size_t start = 0;
+    while (start < comment.size()) {
+        std::size_t end = comment.find('\n', start);
+        end = end == std::string::npos ? comment.size() : end;
+        contents += "# " + comment.substr(start, end - start) + "\n";
+        start = end + 1;
+    }
+    contents += format();
+
+    std::string temporary = path + ".tmp";
+    std::FILE *file = std::fopen(temporary.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    ok = (std::fclose(file) == 0) && ok;
+    return ok && std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+
+const Deviation *IndexTable::find(int row, int upcard) const {
+    for (const Deviation& play : plays) {
+        if (play.row == row && play.upcard == upcard) {
+            return &play;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,56 @@
+#include "headers/handvalue.h"
+#include "headers/trace.h"
+
+/**
+ * @file handvalue.cpp
+ * @brief Implementation of numeric hand evaluation.
+ *
+ * Computes hand totals and compares them without building any strings, so the same code
+ * can be used by the UI and by headless runs.
+ */
+
+
+/**
+ * @brief Evaluates a sequence of cards.
+ * @param cards Pointer to the first card of the hand.
+ * @param count Number of cards in the hand.
+ * @return The hand's best total together with its bust and soft flags.
+ */
+HandValue evaluateHand(const Card *cards, std::size_t count) {
+    TRACE_SCOPE("evaluateHand");
+    int hardTotal = 0;
+    bool hasAce = false;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        hardTotal += cards[i].value;
+        hasAce = hasAce || cards[i].name == ACE;
+    }
+
+    HandValue result;
+    result.soft = hasAce && hardTotal + 10 <= 21;
+    result.total = result.soft ? hardTotal + 10 : hardTotal;
+    result.bust = result.total > 21;
+    return result;
+}
+
+
+/**
+ * @brief Compares a player's hand with the dealer's.
+ * @param dealerValue The dealer's evaluated hand.
+ * @param playerValue The player's evaluated hand.
+ * @return OUTCOME_LOSE if the dealer wins, OUTCOME_WIN if the player wins, OUTCOME_PUSH on a tie.
+ *
+ * A busted player always loses, even if the dealer busts as well.
+ */
+HandOutcome compareHandValues(const HandValue& dealerValue, const HandValue& playerValue) {
+    if (playerValue.bust) {
+        return OUTCOME_LOSE;
+    } else if (dealerValue.bust) {
+        return OUTCOME_WIN;
+    } else if (dealerValue.total > playerValue.total) {
+        return OUTCOME_LOSE;
+    } else if (playerValue.total > dealerValue.total) {
+        return OUTCOME_WIN;
+    }
+    return OUTCOME_PUSH;
+}
@@ -0,0 +1,210 @@
+#include "headers/log.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+/**
+ * @file log.cpp
+ * @brief Implementation of the asynchronous log writer.
+ *
+ * Callers format their message straight into a slot of a bounded ring buffer and return.
+ * Slots are claimed with a compare-and-swap on a sequence number per slot, so any number of
+ * threads can log at once without taking a lock. A single background thread drains the ring
+ * in batches and issues one write and one flush per batch. When the ring is full new
+ * messages are dropped and counted rather than blocking the caller.
+ */
+
+
+namespace logging {
+
+namespace {
+
+constexpr std::size_t SLOT_COUNT = 1024; // must be a power of two
+constexpr std::size_t MESSAGE_SIZE = 240;
+constexpr std::chrono::milliseconds IDLE_WAIT(20);
+
+/// Short tag printed in front of each message.
+const char *levelName(Level level) {
+    switch (level) {
+    case LEVEL_DEBUG: return "DEBUG";
+    case LEVEL_INFO: return "INFO";
+    case LEVEL_WARN: return "WARN";
+    case LEVEL_ERROR: return "ERROR";
+    default: return "?";
+    }
+}
+
+/// One message waiting to be written.
+struct Slot {
+    std::atomic<std::size_t> sequence;
+    Level level;
+    char text[MESSAGE_SIZE];
+};
+
+
+/**
+ * @class AsyncWriter
+ * @brief Ring buffer of pending messages plus the thread that writes them out.
+ */
+class AsyncWriter {
+public:
+    AsyncWriter() {
+        for (std::size_t i = 0; i < SLOT_COUNT; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        worker = std::thread(&AsyncWriter::run, this);
+    }
+
+    ~AsyncWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    void push(Level level, const char *format, va_list args) {
+        std::size_t position = enqueuePos.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;) {
+            slot = &slots[position & (SLOT_COUNT - 1)];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            std::intptr_t difference = (std::intptr_t) sequence - (std::intptr_t) position;
+            if (difference == 0) {
+                if (enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed); // ring is full
+                return;
+            } else {
+                position = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->level = level;
+        std::vsnprintf(slot->text, MESSAGE_SIZE, format, args);
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    void flush() {
+        std::size_t target = enqueuePos.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(mutex);
+        flushRequested = true;
+        wake.notify_one();
+        drained.wait(lock, [&] { return written >= target; });
+    }
+
+    void setOutput(std::FILE *stream) {
+        output.store(stream, std::memory_order_relaxed);
+    }
+
+private:
+    /// Writes every published message; returns how many were written.
+    std::size_t drain() {
+        std::FILE *stream = output.load(std::memory_order_relaxed);
+        std::size_t count = 0;
+        for (;;) {
+            Slot &slot = slots[dequeuePos & (SLOT_COUNT - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+                break;
+            }
+            std::fprintf(stream, "[%s] %s\n", levelName(slot.level), slot.text);
+            slot.sequence.store(dequeuePos + SLOT_COUNT, std::memory_order_release);
+            ++dequeuePos;
+            ++count;
+        }
+
+        std::size_t lost = dropped.exchange(0, std::memory_order_relaxed);
+        if (lost > 0) {
+            std::fprintf(stream, "[WARN] log buffer full, dropped %zu messages\n", lost);
+        }
+        if (count > 0 || lost > 0) {
+            std::fflush(stream);
+        }
+        return count;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            lock.unlock();
+            drain();
+            lock.lock();
+
+            written = dequeuePos;
+            drained.notify_all();
+            if (stopping) {
+                lock.unlock();
+                drain();
+                return;
+            }
+            wake.wait_for(lock, IDLE_WAIT, [&] { return stopping || flushRequested; });
+            flushRequested = false;
+        }
+    }
+
+    Slot slots[SLOT_COUNT];
+    alignas(64) std::atomic<std::size_t> enqueuePos{0};
+    alignas(64) std::size_t dequeuePos = 0; // only touched by the writer thread
+    std::atomic<std::size_t> dropped{0};
+    std::atomic<std::FILE*> output{stderr};
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    std::size_t written = 0;
+    bool flushRequested = false;
+    bool stopping = false;
+    std::thread worker;
+};
+
+
+AsyncWriter& writer() {
+    static AsyncWriter instance;
+    return instance;
+}
+
+} // namespace
+
+
+/**
+ * @brief Formats a message and queues it for the background writer.
+ * @param level Severity of the message.
+ * @param format printf-style format string, followed by its arguments.
+ *
+ * Messages longer than the slot size are truncated. Use the LOG_* macros rather than
+ * calling this directly so that disabled levels are compiled out.
+ */
+void write(Level level, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    writer().push(level, format, args);
+    va_end(args);
+}
+
+
+/**
+ * @brief Redirects log output.
+ * @param stream An open stdio stream; it must outlive the logger.
+ */
+void setOutput(std::FILE *stream) {
+    writer().setOutput(stream);
+}
+
+
+/**
+ * @brief Waits until every message logged before this call has been written.
+ */
+void flush() {
+    writer().flush();
+}
+
+} // namespace logging
@@ -0,0 +1,370 @@
+#include "headers/metrics.h"
+
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define BJ_METRICS_HAVE_UNIX_SOCKETS 1
+#endif
+
+/**
+ * @file metrics.cpp
+ * @brief Implementation of the metrics registry and its exporters.
+ *
+ * Metrics register themselves during static initialisation, so the registry is only locked
+ * when a metric is created or a snapshot is rendered, never when a metric is updated.
+ *
+ * Building with BJ_METRICS_COUNT_ALLOCATIONS replaces the global operator new so that every
+ * heap allocation in the process is counted; otherwise the allocation count reads zero.
+ */
+
+
+namespace {
+
+std::atomic<std::uint64_t> allocations{0};
+
+} // namespace
+
+
+#ifdef BJ_METRICS_COUNT_ALLOCATIONS
+
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+#endif
+
+
+namespace metrics {
+
+namespace {
+
+/// Every metric created so far, in creation order.
+struct Registry {
+    std::mutex mutex;
+    std::vector<Counter*> counters;
+    std::vector<Gauge*> gauges;
+    std::vector<Histogram*> histograms;
+
+    // State for deriving hands per second between snapshots.
+    std::uint64_t lastHands = 0;
+    std::chrono::steady_clock::time_point lastSnapshot = std::chrono::steady_clock::now();
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+
+/// Background thread shared by both exporters; only one runs at a time.
+struct Exporter {
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread worker;
+};
+
+Exporter exporter;
+
+
+bool writeFileAtomically(const std::string &path, const std::string &contents) {
+    std::string temporary = path + ".tmp";
+    std::FILE *file = std::fopen(temporary.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    ok = (std::fclose(file) == 0) && ok;
+    return ok && std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+
+void appendHeader(std::string &out, const char *name, const char *help, const char *type) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+void appendValue(std::string &out, const char *format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    out += line;
+}
+
+} // namespace
+
+
+Counter handsPlayed("bj_hands_played_total", "Player hands settled.");
+Counter shuffles("bj_shuffles_total", "Shoes built and shuffled.");
+Counter reshuffles("bj_reshuffles_total", "Shuffles of a shoe that had already dealt cards.");
+Gauge walletBalance("bj_wallet_balance", "Current wallet balance in dollars.");
+
+Histogram dealLatency("bj_ui_deal_latency_us", "Time spent in GameUI::onDealClicked.");
+Histogram hitLatency("bj_ui_hit_latency_us", "Time spent in GameUI::onHitClicked.");
+Histogram standLatency("bj_ui_stand_latency_us", "Time spent in GameUI::onStandClicked.");
+Histogram doubleLatency("bj_ui_double_latency_us", "Time spent in GameUI::onDoubleClicked.");
+Histogram endRoundLatency("bj_ui_end_round_latency_us", "Time spent in GameUI::onEndClicked.");
+
+Histogram adviceLatency("bj_advice_latency_us", "Time the advisor spent evaluating one decision.");
+
+
+Counter::Counter(const char *name, const char *help) : name(name), help(help) {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    registry().counters.push_back(this);
+}
+
+Gauge::Gauge(const char *name, const char *help) : name(name), help(help) {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    registry().gauges.push_back(this);
+}
+
+Histogram::Histogram(const char *name, const char *help) : name(name), help(help) {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    registry().histograms.push_back(this);
+}
+
+
+/**
+ * @brief Records one observation.
+ * @param microseconds The observed latency.
+ */
+void Histogram::observe(std::uint64_t microseconds) {
+    int index = 0;
+    while (index < BUCKET_COUNT - 1 && (std::uint64_t(1) << index) < microseconds) {
+        ++index;
+    }
+    buckets[index].fetch_add(1, std::memory_order_relaxed);
+    observations.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(microseconds, std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Number of heap allocations made so far.
+ * @return The count, or zero unless built with BJ_METRICS_COUNT_ALLOCATIONS.
+ */
+std::uint64_t allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Renders every registered metric in Prometheus text format.
+ * @return The exposition text.
+ *
+ * Also reports hands per second, measured since the previous snapshot.
+ */
+std::string snapshot() {
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::string out;
+
+    for (const Counter *counter : reg.counters) {
+        appendHeader(out, counter->name, counter->help, "counter");
+        appendValue(out, "%s %llu\n", counter->name, (unsigned long long) counter->get());
+    }
+
+    appendHeader(out, "bj_allocations_total", "Heap allocations made by the process.", "counter");
+    appendValue(out, "bj_allocations_total %llu\n", (unsigned long long) allocationCount());
+
+    for (const Gauge *gauge : reg.gauges) {
+        appendHeader(out, gauge->name, gauge->help, "gauge");
+        appendValue(out, "%s %.17g\n", gauge->name, gauge->get());
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::uint64_t hands = handsPlayed.get();
+    double seconds = std::chrono::duration<double>(now - reg.lastSnapshot).count();
+    double handsPerSecond = seconds > 0 ? (hands - reg.lastHands) / seconds : 0.0;
+    reg.lastHands = hands;
+    reg.lastSnapshot = now;
+    appendHeader(out, "bj_hands_per_second", "Hands settled per second since the previous snapshot.", "gauge");
+    appendValue(out, "bj_hands_per_second %.3f\n", handsPerSecond);
+
+    for (const Histogram *histogram : reg.histograms) {
+        appendHeader(out, histogram->name, histogram->help, "histogram");
+        std::uint64_t cumulative = 0;
+        for (int i = 0; i < Histogram::BUCKET_COUNT - 1; ++i) {
+            cumulative += histogram->bucket(i);
+            appendValue(out, "%s_bucket{le=\"%llu\"} %llu\n", histogram->name,
+                        1ULL << i, (unsigned long long) cumulative);
+        }
+        cumulative += histogram->bucket(Histogram::BUCKET_COUNT - 1);
+        appendValue(out, "%s_bucket{le=\"+Inf\"} %llu\n", histogram->name, (unsigned long long) cumulative);
+        appendValue(out, "%s_sum %llu\n", histogram->name, (unsigned long long) histogram->sum());
+        appendValue(out, "%s_count %llu\n", histogram->name, (unsigned long long) histogram->count());
+    }
+
+    return out;
+}
+
+
+/**
+ * @brief Starts writing snapshots to a file at a fixed interval.
+ * @param path File to replace with each snapshot.
+ * @param interval Time between snapshots.
+ * @return False if an exporter is already running.
+ */
+bool startFileExporter(const std::string &path, std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(exporter.mutex);
+    if (exporter.worker.joinable()) {
+        return false;
+    }
+    exporter.stopping = false;
+    exporter.worker = std::thread([path, interval] {
+        std::unique_lock<std::mutex> lock(exporter.mutex);
+        while (!exporter.stopping) {
+            lock.unlock();
+            writeFileAtomically(path, snapshot());
+            lock.lock();
+            exporter.wake.wait_for(lock, interval, [] { return exporter.stopping; });
+        }
+        lock.unlock();
+        writeFileAtomically(path, snapshot());
+    });
+    return true;
+}
+
+
+/**
+ * @brief Serves a snapshot to every client that connects to a Unix domain socket.
+ * @param path Filesystem path of the socket; an existing file there is removed.
+ * @return False if sockets are unavailable, the socket cannot be created, or an exporter is
+ *         already running.
+ */
+bool startSocketExporter(const std::string &path) {
+#ifdef BJ_METRICS_HAVE_UNIX_SOCKETS
+    std::lock_guard<std::mutex> lock(exporter.mutex);
+    if (exporter.worker.joinable()) {
+        return false;
+    }
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    path.copy(address.sun_path, path.size());
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        return false;
+    }
+    ::unlink(path.c_str());
+    if (::bind(listener, (sockaddr*) &address, sizeof(address)) != 0 || ::listen(listener, 4) != 0) {
+        ::close(listener);
+        return false;
+    }
+
+    exporter.stopping = false;
+    exporter.worker = std::thread([listener, path] {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(exporter.mutex);
+                if (exporter.stopping) {
+                    break;
+                }
+            }
+            pollfd request = {listener, POLLIN, 0};
+            if (::poll(&request, 1, 200) <= 0) {
+                continue;
+            }
+            int client = ::accept(listener, nullptr, nullptr);
+            if (client < 0) {
+                continue;
+            }
+            std::string text = snapshot();
+            std::size_t sent = 0;
+            while (sent < text.size()) {
+                ssize_t written = ::write(client, text.data() + sent, text.size() - sent);
+                if (written <= 0) {
+                    break;
+                }
+                sent += (std::size_t) written;
+            }
+            ::close(client);
+        }
+        ::close(listener);
+        ::unlink(path.c_str());
+    });
+    return true;
+#else
+    (void) path;
+    return false;
+#endif
+}
+
+
+/**
+ * @brief Stops the running exporter, if any, after one final snapshot for file exports.
+ */
+void stopExporter() {
+    {
+        std::lock_guard<std::mutex> lock(exporter.mutex);
+        if (!exporter.worker.joinable()) {
+            return;
+        }
+        exporter.stopping = true;
+    }
+    exporter.wake.notify_all();
+    exporter.worker.join();
+}
+
+
+/**
+ * @brief Starts an exporter from environment variables.
+ *
+ * BJ_METRICS_SOCKET selects a Unix domain socket path; otherwise BJ_METRICS_FILE selects a
+ * file, written every BJ_METRICS_INTERVAL_MS milliseconds (5000 by default). The exporter
+ * is stopped automatically at exit.
+ */
+void startFromEnvironment() {
+    const char *socketPath = std::getenv("BJ_METRICS_SOCKET");
+    const char *filePath = std::getenv("BJ_METRICS_FILE");
+    const char *intervalText = std::getenv("BJ_METRICS_INTERVAL_MS");
+
+    bool started = false;
+    if (socketPath != nullptr && socketPath[0] != '\0') {
+        started = startSocketExporter(socketPath);
+    } else if (filePath != nullptr && filePath[0] != '\0') {
+        long interval = intervalText != nullptr ? std::atol(intervalText) : 0;
+        started = startFileExporter(filePath, std::chrono::milliseconds(interval > 0 ? interval : 5000));
+    }
+    if (started) {
+        std::atexit(stopExporter);
+    }
+}
+
+} // namespace metrics
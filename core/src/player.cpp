@@ -0,0 +1,171 @@
+#include <cstdlib>
+#include <ctime>
+
+#include "headers/player.h"
+#include <utility>
+
+
+/**
+ * @file player.cpp
+ * @brief Implementation of the player class for card game operations.
+ *
+ * Contains the definitions of player actions such as hitting, standing, and evaluating
+ * the hand's value. The player can draw cards from the deck, decide to stand, and calculate
+ * the total value of their hand considering the dual nature of Aces.
+ *
+ * @author Hsiao Yuan Lu
+ */
+
+
+
+
+/**
+ * @brief Draws a card from the deck and adds it to the player's hand.
+ *
+ * This function checks if the deck pointer is not null before drawing a card.
+ * If the deck is valid, it draws a card from the deck and adds it to the player's hand.
+ */
+void player::Hit() {
+    if (deck != nullptr) { // Check if the deck pointer is not null
+        Card newCard = deck->drawCard(); // Use the drawCard() method
+        CurrentHand().add(newCard); // Add the drawn card to the active hand
+    }
+}
+
+
+void player::Stand(){
+    //stand so nothing happens
+}
+
+
+/**
+ * @brief Doubles the bet on the active hand and draws its one final card.
+ */
+void player::Double() {
+    DoubleBet();
+    Hit();
+}
+
+
+/**
+ * @brief Doubles the bet on the active hand without drawing.
+ */
+void player::DoubleBet() {
+    Hand& hand = CurrentHand();
+    hand.bet *= 2;
+    hand.doubled = true;
+}
+
+
+/**
+ * @brief Splits the active pair into two hands and gives each a second card.
+ *
+ * Callers check CanSplit() first.
+ */
+void player::Split() {
+    Hand& added = SplitPair();
+    Hit();
+    if (deck != nullptr) {
+        added.add(deck->drawCard());
+    }
+}
+
+
+/**
+ * @brief Splits the active pair into two one-card hands without drawing.
+ *
+ * The second card of the pair moves to a new hand at the end of the seat, so the
+ * indices of hands already on the table never change. Both hands carry the original
+ * bet and are marked as split, which keeps a later 21 from paying as a blackjack.
+ *
+ * @return The new hand; the active hand stays the first one.
+ */
+Hand& player::SplitPair() {
+    Hand& current = CurrentHand();
+    Hand& added = hands[handCount++];
+
+    added.clear();
+    added.bet = current.bet;
+    added.fromSplit = true;
+    added.add(current.cards[1]);
+
+    current.count = 1;
+    current.fromSplit = true;
+    return added;
+}
+
+
+bool player::CanSplit(int maxHands, bool resplitAces) const {
+    const Hand& hand = CurrentHand();
+    if (!hand.isPair() || handCount >= maxHands || handCount >= MAX_SPLIT_HANDS) {
+        return false;
+    }
+    return resplitAces || !hand.isSplitAces();
+}
+
+
+bool player::NextHand() {
+    if (activeHand + 1 >= handCount) {
+        return false;
+    }
+    activeHand++;
+    return true;
+}
+
+
+void player::Reset() {
+    for (int i = 0; i < handCount; i++) {
+        hands[i].clear();
+    }
+    handCount = 1;
+    activeHand = 0;
+    insured = false;
+}
+
+
+/**
+ * @brief Adds a given card to the active hand without drawing from the deck.
+ * @param specificCard The card to add.
+ */
+void player::AddCardToHand(const Card& specificCard) {
+    CurrentHand().add(specificCard);
+}
+
+/**
+ * @brief Calculates the total value of the player's active hand.
+ *
+ * Evaluates the player's hand and returns a pair of integers representing the minimum
+ * and maximum values of the hand. This accounts for Aces being either 1 or 11.
+ * @return A pair of integers: the first is the minimum value of the hand,
+ *         the second is the maximum value considering Aces.
+ */
+std::pair<int, int> player::CheckHand() {
+    int minSum = 0;
+    int maxSum = 0;
+
+    const Hand& hand = CurrentHand();
+    for (int i = 0; i < hand.count; ++i) {
+
+        if(hand.cards[i].isAce()){
+            minSum += hand.cards[i].value;
+            maxSum = minSum + 10;
+        }
+        else{
+            minSum += hand.cards[i].value;
+            maxSum += hand.cards[i].value;
+        }
+    }
+    return std::make_pair(minSum, maxSum);
+}
+
+
+
+
+
+/**
+ * @brief Evaluates the player's hand without building any strings.
+ * @return A HandValue holding the best total and the bust and soft flags.
+ */
+HandValue player::GetHandValue() const {
+    return CurrentHand().value();
+}
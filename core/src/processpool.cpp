@@ -0,0 +1,281 @@
+#include "headers/processpool.h"
+#include "headers/log.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define BJ_PROCESSPOOL_HAVE_FORK 1
+#endif
+
+/**
+ * @file processpool.cpp
+ * @brief Forking, feeding and replacing worker processes.
+ *
+ * The coordinator writes a shard number to a worker's task pipe and waits, with poll() over
+ * every busy worker's result pipe, for the shard number, a 64-bit length and the result.
+ * Writing a shard number that cannot be run stops the worker. A result pipe that closes
+ * before the whole result has arrived means the worker is gone.
+ */
+
+
+#ifdef BJ_PROCESSPOOL_HAVE_FORK
+
+namespace {
+
+constexpr std::uint32_t STOP_SHARD = 0xffffffffU;
+constexpr std::size_t RESULT_HEADER = sizeof(std::uint32_t) + sizeof(std::uint64_t);
+
+bool writeAll(int fd, const void *data, std::size_t size) {
+    const char *bytes = static_cast<const char *>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= (std::size_t) written;
+    }
+    return true;
+}
+
+bool readAll(int fd, void *data, std::size_t size) {
+    char *bytes = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t got = read(fd, bytes, size);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        bytes += got;
+        size -= (std::size_t) got;
+    }
+    return true;
+}
+
+
+/// A worker process and the shard it is running.
+struct Worker {
+    pid_t pid = -1;
+    int tasks = -1;       /// Write end of the pipe to the worker.
+    int results = -1;     /// Read end of the pipe from the worker.
+    int shard = -1;       /// Shard being run, or -1 while idle.
+    int attempt = 0;      /// Which attempt at the shard this is.
+    std::string buffer;   /// Bytes of the result read so far.
+};
+
+
+/// Body of a worker: runs shards until told to stop or the coordinator goes away.
+[[noreturn]] void serve(int tasks, int results, const std::function<std::string(int)>& work) {
+    for (;;) {
+        std::uint32_t shard = STOP_SHARD;
+        if (!readAll(tasks, &shard, sizeof shard) || shard == STOP_SHARD) {
+            _exit(0);
+        }
+        std::string result = work((int) shard);
+        std::uint64_t size = result.size();
+        if (!writeAll(results, &shard, sizeof shard) || !writeAll(results, &size, sizeof size)
+            || !writeAll(results, result.data(), result.size())) {
+            _exit(1);
+        }
+    }
+}
+
+
+bool spawn(Worker& worker, const std::vector<Worker>& workers, const std::function<std::string(int)>& work) {
+    int toWorker[2];
+    int fromWorker[2];
+    if (pipe(toWorker) != 0) {
+        return false;
+    }
+    if (pipe(fromWorker) != 0) {
+        close(toWorker[0]);
+        close(toWorker[1]);
+        return false;
+    }
+    std::fflush(nullptr); // or the worker would write out the coordinator's buffered output again
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(toWorker[0]);
+        close(toWorker[1]);
+        close(fromWorker[0]);
+        close(fromWorker[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(toWorker[1]);
+        close(fromWorker[0]);
+        for (const Worker& other : workers) {
+            if (other.pid > 0) {
+                close(other.tasks);
+                close(other.results);
+            }
+        }
+        serve(toWorker[0], fromWorker[1], work);
+    }
+    close(toWorker[0]);
+    close(fromWorker[1]);
+    worker = Worker();
+    worker.pid = pid;
+    worker.tasks = toWorker[1];
+    worker.results = fromWorker[0];
+    return true;
+}
+
+
+void retire(Worker& worker) {
+    close(worker.tasks);
+    close(worker.results);
+    waitpid(worker.pid, nullptr, 0);
+    worker.pid = -1;
+    worker.shard = -1;
+}
+
+} // namespace
+
+#endif // BJ_PROCESSPOOL_HAVE_FORK
+
+
+int runShardsInProcesses(const std::vector<int>& order, int processes, int attempts,
+                         const std::function<std::string(int)>& work,
+                         const std::function<void(int, const std::string *)>& done) {
+#ifndef BJ_PROCESSPOOL_HAVE_FORK
+    (void) processes;
+    (void) attempts;
+    for (int shard : order) {
+        std::string result = work(shard);
+        done(shard, &result);
+    }
+    return 0;
+#else
+    struct Pending {
+        int shard;
+        int attempts; /// Attempts already made.
+    };
+    std::deque<Pending> pending;
+    for (int shard : order) {
+        pending.push_back(Pending{shard, 0});
+    }
+    std::vector<Worker> workers(std::max<std::size_t>(1, std::min<std::size_t>(processes, order.size())));
+    int lost = 0;
+    void (*previousHandler)(int) = std::signal(SIGPIPE, SIG_IGN);
+
+    // A worker that has gone away: reap it and give its shard another attempt if it has any left.
+    auto fail = [&](Worker& worker) {
+        int shard = worker.shard;
+        int attempt = worker.attempt;
+        int pid = (int) worker.pid;
+        retire(worker);
+        if (shard < 0) {
+            return;
+        } else if (attempt < attempts) {
+            LOG_WARN("Worker process %d stopped during shard %d; running it again", pid, shard);
+            pending.push_front(Pending{shard, attempt});
+        } else {
+            LOG_ERROR("Worker process %d stopped during shard %d; giving the shard up", pid, shard);
+            ++lost;
+            done(shard, nullptr);
+        }
+    };
+
+    std::vector<pollfd> polled;
+    std::vector<Worker *> polledWorkers;
+    for (;;) {
+        for (Worker& worker : workers) {
+            if (pending.empty()) {
+                break;
+            }
+            if (worker.pid < 0 && !spawn(worker, workers, work)) {
+                continue;
+            }
+            if (worker.shard < 0) {
+                Pending next = pending.front();
+                pending.pop_front();
+                worker.shard = next.shard;
+                worker.attempt = next.attempts + 1;
+                worker.buffer.clear();
+                std::uint32_t shard = (std::uint32_t) next.shard;
+                if (!writeAll(worker.tasks, &shard, sizeof shard)) {
+                    fail(worker);
+                }
+            }
+        }
+
+        polled.clear();
+        polledWorkers.clear();
+        for (Worker& worker : workers) {
+            if (worker.pid > 0 && worker.shard >= 0) {
+                polled.push_back(pollfd{worker.results, POLLIN, 0});
+                polledWorkers.push_back(&worker);
+            }
+        }
+        if (polled.empty()) {
+            // Nothing running: either everything is done, or no worker could be started.
+            while (!pending.empty()) {
+                ++lost;
+                done(pending.front().shard, nullptr);
+                pending.pop_front();
+            }
+            break;
+        }
+        if (poll(polled.data(), polled.size(), -1) < 0) {
+            continue; // EINTR
+        }
+
+        for (std::size_t index = 0; index < polled.size(); ++index) {
+            if (polled[index].revents == 0) {
+                continue;
+            }
+            Worker& worker = *polledWorkers[index];
+            char chunk[65536];
+            ssize_t got = read(worker.results, chunk, sizeof chunk);
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got <= 0) {
+                fail(worker);
+                continue;
+            }
+            worker.buffer.append(chunk, (std::size_t) got);
+            if (worker.buffer.size() < RESULT_HEADER) {
+                continue;
+            }
+            std::uint32_t shard = 0;
+            std::uint64_t size = 0;
+            worker.buffer.copy(reinterpret_cast<char *>(&shard), sizeof shard, 0);
+            worker.buffer.copy(reinterpret_cast<char *>(&size), sizeof size, sizeof shard);
+            if ((int) shard != worker.shard) {
+                kill(worker.pid, SIGKILL);
+                fail(worker);
+            } else if (worker.buffer.size() >= RESULT_HEADER + size) {
+                std::string result = worker.buffer.substr(RESULT_HEADER, size);
+                worker.buffer.clear();
+                worker.shard = -1;
+                done((int) shard, &result);
+            }
+        }
+    }
+
+    for (Worker& worker : workers) {
+        if (worker.pid > 0) {
+            std::uint32_t stop = STOP_SHARD;
+            writeAll(worker.tasks, &stop, sizeof stop);
+            retire(worker);
+        }
+    }
+    std::signal(SIGPIPE, previousHandler);
+    return lost;
+#endif
+}
@@ -0,0 +1,298 @@
+#include "headers/removal.h"
+#include "headers/analyzer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+/**
+ * @file removal.cpp
+ * @brief Effects of removal from exact analyses, and count evaluation from them.
+ */
+
+
+namespace {
+
+/// Value of an action, or nothing if the hand cannot take it.
+bool actionValue(const ActionValues& values, Action action, double& value) {
+    switch (action) {
+    case ACTION_STAND: value = values.stand; return true;
+    case ACTION_HIT: value = values.hit; return true;
+    case ACTION_DOUBLE: value = values.doubleDown; return values.canDouble;
+    case ACTION_SPLIT: value = values.split; return values.canSplit;
+    case ACTION_SURRENDER: value = values.surrender; return values.canSurrender;
+    }
+    return false;
+}
+
+
+/// Best and second-best available actions.
+void rankActions(const ActionValues& values, Action& best, Action& runnerUp) {
+    double bestValue = -1e9;
+    double runnerUpValue = -1e9;
+    best = runnerUp = ACTION_STAND;
+    for (int index = 0; index < ACTION_KINDS; ++index) {
+        double value;
+        if (!actionValue(values, Action(index), value)) {
+            continue;
+        }
+        if (value > bestValue) {
+            runnerUp = best;
+            runnerUpValue = bestValue;
+            best = Action(index);
+            bestValue = value;
+        } else if (value > runnerUpValue) {
+            runnerUp = Action(index);
+            runnerUpValue = value;
+        }
+    }
+}
+
+
+double gapBetween(const ActionValues& values, Action best, Action runnerUp) {
+    double bestValue = 0.0;
+    double runnerUpValue = 0.0;
+    actionValue(values, best, bestValue);
+    actionValue(values, runnerUp, runnerUpValue);
+    return bestValue - runnerUpValue;
+}
+
+
+/// Builds one rule set's effects from its full-shoe analysis and one per rank removed.
+RemovalEffects collectEffects(const RuleSet& rules, const AnalysisReport& full, const AnalysisReport *const *removed) {
+    RemovalEffects effects;
+    effects.rules = rules;
+    effects.expectedValue = full.expectedValue;
+    for (int rank = 0; rank < RANKS; ++rank) {
+        effects.effect[rank] = removed[rank]->expectedValue - full.expectedValue;
+    }
+
+    ShoeComposition shoe = ShoeComposition::fullShoe(rules.decks);
+    for (int upcard = 0; upcard < RANKS; ++upcard) {
+        for (int first = 0; first < RANKS; ++first) {
+            for (int second = first; second < RANKS; ++second) {
+                if (first == 0 && second == RANKS - 1) {
+                    continue; // blackjack, no decision
+                }
+                ShoeComposition left = shoe;
+                DecisionEffect decision;
+                decision.upcard = upcard;
+                decision.first = first;
+                decision.second = second;
+                decision.frequency = left.probability(upcard);
+                left.remove(upcard);
+                decision.frequency *= left.probability(first);
+                left.remove(first);
+                decision.frequency *= left.probability(second) * (first == second ? 1.0 : 2.0);
+                const ActionValues& values = full.hands[upcard][first][second];
+                rankActions(values, decision.best, decision.runnerUp);
+                decision.gap = gapBetween(values, decision.best, decision.runnerUp);
+                for (int rank = 0; rank < RANKS; ++rank) {
+                    decision.effect[rank] = gapBetween(removed[rank]->hands[upcard][first][second], decision.best,
+                                                       decision.runnerUp) - decision.gap;
+                }
+                effects.decisions.push_back(decision);
+            }
+        }
+    }
+    return effects;
+}
+
+
+/// Share of a shoe's cards that are of each rank.
+void rankShares(double share[RANKS]) {
+    for (int rank = 0; rank < RANKS; ++rank) {
+        share[rank] = rank == RANKS - 1 ? 16.0 / 52.0 : 4.0 / 52.0;
+    }
+}
+
+
+/// Correlation between tags and effects over the cards of a shoe.
+double correlation(const int tags[RANKS], const double effect[RANKS]) {
+    double share[RANKS];
+    rankShares(share);
+    double tagMean = 0.0;
+    double effectMean = 0.0;
+    for (int rank = 0; rank < RANKS; ++rank) {
+        tagMean += share[rank] * tags[rank];
+        effectMean += share[rank] * effect[rank];
+    }
+    double covariance = 0.0;
+    double tagVariance = 0.0;
+    double effectVariance = 0.0;
+    for (int rank = 0; rank < RANKS; ++rank) {
+        covariance += share[rank] * (tags[rank] - tagMean) * (effect[rank] - effectMean);
+        tagVariance += share[rank] * (tags[rank] - tagMean) * (tags[rank] - tagMean);
+        effectVariance += share[rank] * (effect[rank] - effectMean) * (effect[rank] - effectMean);
+    }
+    return tagVariance > 0.0 && effectVariance > 0.0 ? covariance / std::sqrt(tagVariance * effectVariance) : 0.0;
+}
+
+
+/// Expected gain from taking the other action whenever an estimate of the change in the gap,
+/// normal with the given spread, says it has closed.
+double switchingGain(double gap, double spread) {
+    if (spread <= 0.0) {
+        return 0.0;
+    }
+    double z = gap / spread;
+    double density = std::exp(-0.5 * z * z) / std::sqrt(2.0 * M_PI);
+    return spread * density - gap * 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+} // namespace
+
+
+std::vector<RemovalEffects> computeRemovalEffects(const std::vector<RuleSet>& rules, int threads) {
+    // Job j analyses rule set j / (RANKS + 1), with rank j % (RANKS + 1) - 1 removed (none for -1).
+    int jobs = (int) rules.size() * (RANKS + 1);
+    std::vector<std::unique_ptr<AnalysisReport>> reports(jobs);
+    std::atomic<int> next(0);
+    auto work = [&]() {
+        for (int job = next++; job < jobs; job = next++) {
+            const RuleSet& table = rules[job / (RANKS + 1)];
+            int rank = job % (RANKS + 1) - 1;
+            ShoeComposition shoe = ShoeComposition::fullShoe(table.decks);
+            for (int card = 0; rank >= 0 && card < table.decks; ++card) {
+                shoe.remove(rank);
+            }
+            reports[job].reset(new AnalysisReport(analyzeShoe(table, shoe, 1)));
+        }
+    };
+    if (threads <= 0) {
+        threads = (int) std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, std::max(jobs, 1));
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    std::vector<RemovalEffects> effects;
+    for (std::size_t index = 0; index < rules.size(); ++index) {
+        const AnalysisReport *removed[RANKS];
+        for (int rank = 0; rank < RANKS; ++rank) {
+            removed[rank] = reports[index * (RANKS + 1) + rank + 1].get();
+        }
+        effects.push_back(collectEffects(rules[index], *reports[index * (RANKS + 1)], removed));
+    }
+    return effects;
+}
+
+
+CountEvaluation evaluateCount(const RemovalEffects& effects, const int tags[RANKS]) {
+    CountEvaluation evaluation;
+    evaluation.betting = correlation(tags, effects.effect);
+
+    // Removing a ten lowers the insurance value by 9 parts for every 4 that removing any
+    // other card raises it.
+    double insurance[RANKS];
+    for (int rank = 0; rank < RANKS; ++rank) {
+        insurance[rank] = rank == RANKS - 1 ? -9.0 : 4.0;
+    }
+    evaluation.insurance = correlation(tags, insurance);
+
+    // Spread of a sum of effects over n of the N cards dealt at random, per card removed
+    // (one card per deck is decks cards), and scaled up as the shoe shrinks to N - n.
+    double cards = 52.0 * effects.rules.decks;
+    double dealt = 0.5 * effects.rules.penetration * cards;
+    double spreadScale = std::sqrt(dealt * (cards - dealt) / (cards - 1.0)) * cards / (cards - dealt)
+        / effects.rules.decks;
+    double share[RANKS];
+    rankShares(share);
+    double countGain = 0.0;
+    double perfectGain = 0.0;
+    for (const DecisionEffect& decision : effects.decisions) {
+        double mean = 0.0;
+        for (int rank = 0; rank < RANKS; ++rank) {
+            mean += share[rank] * decision.effect[rank];
+        }
+        double variance = 0.0;
+        for (int rank = 0; rank < RANKS; ++rank) {
+            variance += share[rank] * (decision.effect[rank] - mean) * (decision.effect[rank] - mean);
+        }
+        double spread = spreadScale * std::sqrt(variance);
+        double tracking = std::fabs(correlation(tags, decision.effect));
+        countGain += decision.frequency * switchingGain(decision.gap, tracking * spread);
+        perfectGain += decision.frequency * switchingGain(decision.gap, spread);
+    }
+    evaluation.playing = perfectGain > 0.0 ? countGain / perfectGain : 0.0;
+    return evaluation;
+}
+
+
+std::string RemovalEffects::serialize() const {
+    std::string text;
+    char line[512];
+    std::snprintf(line, sizeof line, "ev %.17g\nremoval", expectedValue);
+    text += line;
+    for (int rank = 0; rank < RANKS; ++rank) {
+        std::snprintf(line, sizeof line, " %.17g", effect[rank]);
+        text += line;
+    }
+    text += '\n';
+    for (const DecisionEffect& decision : decisions) {
+        std::snprintf(line, sizeof line, "decision %d %d %d %d %d %.17g %.17g", decision.upcard, decision.first,
+                      decision.second, (int) decision.best, (int) decision.runnerUp, decision.frequency, decision.gap);
+        text += line;
+        for (int rank = 0; rank < RANKS; ++rank) {
+            std::snprintf(line, sizeof line, " %.17g", decision.effect[rank]);
+            text += line;
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+
+bool RemovalEffects::parse(const std::string& text) {
+    RemovalEffects parsed;
+    parsed.rules = rules;
+    bool haveValue = false;
+    bool haveRemoval = false;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::istringstream fields(line);
+        std::string keyword;
+        fields >> keyword;
+        if (keyword == "ev") {
+            haveValue = bool(fields >> parsed.expectedValue);
+        } else if (keyword == "removal") {
+            for (int rank = 0; rank < RANKS; ++rank) {
+                fields >> parsed.effect[rank];
+            }
+            haveRemoval = bool(fields);
+        } else if (keyword == "decision") {
+            DecisionEffect decision;
+            int best = 0;
+            int runnerUp = 0;
+            fields >> decision.upcard >> decision.first >> decision.second >> best >> runnerUp >> decision.frequency
+                >> decision.gap;
+            for (int rank = 0; rank < RANKS; ++rank) {
+                fields >> decision.effect[rank];
+            }
+            if (!fields || best < 0 || best >= ACTION_KINDS || runnerUp < 0 || runnerUp >= ACTION_KINDS) {
+                return false;
+            }
+            decision.best = Action(best);
+            decision.runnerUp = Action(runnerUp);
+            parsed.decisions.push_back(decision);
+        } else if (!keyword.empty()) {
+            return false;
+        }
+    }
+    if (!haveValue || !haveRemoval) {
+        return false;
+    }
+    *this = parsed;
+    return true;
+}
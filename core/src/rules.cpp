@@ -0,0 +1,145 @@
+#include "headers/rules.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @file rules.cpp
+ * @brief Validation, hashing, description and command-line parsing of rule sets.
+ */
+
+
+namespace {
+
+/// Mixes one value into a 64-bit FNV-1a hash.
+void hashValue(std::uint64_t& hash, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (8 * i)) & 0xff;
+        hash *= 1099511628211ULL;
+    }
+}
+
+} // namespace
+
+
+/**
+ * @brief Checks that the rules describe a playable table.
+ * @return True if every field is within range.
+ */
+bool RuleSet::isValid() const {
+    return decks >= 1 && decks <= 8
+        && blackjackPayNumerator > 0 && blackjackPayDenominator > 0
+        && maxSplitHands >= 1 && maxSplitHands <= 8
+        && penetration > 0.0 && penetration < 1.0;
+}
+
+
+/**
+ * @brief Computes a canonical hash of the rules.
+ * @return A hash that is equal for rule sets that play identically.
+ *
+ * The blackjack payout is reduced to its ratio and the penetration to a whole number of
+ * tenths of a percent, so that equivalent spellings of the same table hash the same. The
+ * hash is stable across runs and platforms and is suitable as a cache key.
+ */
+std::uint64_t RuleSet::hash() const {
+    std::uint64_t hash = 14695981039346656037ULL;
+    hashValue(hash, (std::uint64_t) decks);
+    hashValue(hash, hitSoft17);
+    hashValue(hash, (std::uint64_t) std::llround(blackjackPayout() * 1000000.0));
+    hashValue(hash, doubleAfterSplit);
+    hashValue(hash, (std::uint64_t) maxSplitHands);
+    hashValue(hash, resplitAces);
+    hashValue(hash, hitSplitAces);
+    hashValue(hash, (std::uint64_t) surrender);
+    hashValue(hash, dealerPeek);
+    hashValue(hash, (std::uint64_t) std::llround(penetration * 1000.0));
+    return hash;
+}
+
+
+/**
+ * @brief Describes the rules in the usual shorthand.
+ * @return For example "6D S17 DAS 3:2 SP4 LS peek pen 75%".
+ */
+std::string RuleSet::describe() const {
+    char text[128];
+    const char *surrenderText = surrender == SURRENDER_LATE ? " LS" : surrender == SURRENDER_EARLY ? " ES" : "";
+    std::snprintf(text, sizeof(text), "%dD %s %s %d:%d SP%d%s%s%s %s pen %.0f%%",
+                  decks, hitSoft17 ? "H17" : "S17", doubleAfterSplit ? "DAS" : "NDAS",
+                  blackjackPayNumerator, blackjackPayDenominator, maxSplitHands,
+                  resplitAces ? " RSA" : "", hitSplitAces ? " HSA" : "", surrenderText,
+                  dealerPeek ? "peek" : "ENHC", penetration * 100.0);
+    return text;
+}
+
+
+/**
+ * @brief Applies one rule option from a command line.
+ * @param rules Rule set to update.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @param index Index of the option to parse.
+ * @return The number of arguments consumed, 0 if argv[index] is not a rule option, or -1 if
+ *         its value is missing or invalid.
+ *
+ * Recognised options: --decks N, --h17, --s17, --das, --no-das, --payout N:D,
+ * --max-splits N, --rsa, --hsa, --surrender none|late|early, --peek, --enhc,
+ * --penetration F.
+ */
+int parseRuleOption(RuleSet& rules, int argc, char *argv[], int index) {
+    const char *option = argv[index];
+    const char *value = index + 1 < argc ? argv[index + 1] : nullptr;
+
+    if (std::strcmp(option, "--h17") == 0) {
+        rules.hitSoft17 = true;
+    } else if (std::strcmp(option, "--s17") == 0) {
+        rules.hitSoft17 = false;
+    } else if (std::strcmp(option, "--das") == 0) {
+        rules.doubleAfterSplit = true;
+    } else if (std::strcmp(option, "--no-das") == 0) {
+        rules.doubleAfterSplit = false;
+    } else if (std::strcmp(option, "--rsa") == 0) {
+        rules.resplitAces = true;
+    } else if (std::strcmp(option, "--hsa") == 0) {
+        rules.hitSplitAces = true;
+    } else if (std::strcmp(option, "--peek") == 0) {
+        rules.dealerPeek = true;
+    } else if (std::strcmp(option, "--enhc") == 0) {
+        rules.dealerPeek = false;
+    } else if (std::strcmp(option, "--decks") == 0) {
+        if (value == nullptr) return -1;
+        rules.decks = std::atoi(value);
+        return rules.isValid() ? 2 : -1;
+    } else if (std::strcmp(option, "--max-splits") == 0) {
+        if (value == nullptr) return -1;
+        rules.maxSplitHands = std::atoi(value);
+        return rules.isValid() ? 2 : -1;
+    } else if (std::strcmp(option, "--penetration") == 0) {
+        if (value == nullptr) return -1;
+        rules.penetration = std::atof(value);
+        return rules.isValid() ? 2 : -1;
+    } else if (std::strcmp(option, "--payout") == 0) {
+        if (value == nullptr || std::sscanf(value, "%d:%d", &rules.blackjackPayNumerator, &rules.blackjackPayDenominator) != 2) {
+            return -1;
+        }
+        return rules.isValid() ? 2 : -1;
+    } else if (std::strcmp(option, "--surrender") == 0) {
+        if (value == nullptr) return -1;
+        if (std::strcmp(value, "none") == 0) {
+            rules.surrender = SURRENDER_NONE;
+        } else if (std::strcmp(value, "late") == 0) {
+            rules.surrender = SURRENDER_LATE;
+        } else if (std::strcmp(value, "early") == 0) {
+            rules.surrender = SURRENDER_EARLY;
+        } else {
+            return -1;
+        }
+        return 2;
+    } else {
+        return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,225 @@
+#include "headers/sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+/**
+ * @file sampler.cpp
+ * @brief Counting tables and backward sampling of ConditionalShoeSampler.
+ */
+
+
+namespace {
+
+/// Number of ways to choose k of n things, as a double; C(416, 208) is about 1e124.
+double choose(int n, int k) {
+    if (k < 0 || k > n) {
+        return 0.0;
+    }
+    return std::exp(std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0));
+}
+
+} // namespace
+
+
+ConditionalShoeSampler::ConditionalShoeSampler(int decks, CountingSystem system, int cardsDealt)
+    : decks(decks), system(system), depth(cardsDealt), full(ShoeComposition::fullShoe(decks)) {
+    int largestTag = 0;
+    for (int rank = 0; rank < RANKS; ++rank) {
+        int tag = COUNTING_TAGS[system].tags[rank];
+        auto match = std::find_if(classes.begin(), classes.end(), [tag](const TagClass& c) { return c.tag == tag; });
+        if (match == classes.end()) {
+            classes.push_back(TagClass{tag, 0, {}, {}});
+            match = classes.end() - 1;
+        }
+        match->cards += full.counts[rank];
+        match->ranks.push_back(rank);
+        largestTag = std::max(largestTag, std::abs(tag));
+    }
+    for (TagClass& tagClass : classes) {
+        for (int picked = 0; picked <= std::min(tagClass.cards, depth); ++picked) {
+            tagClass.choose.push_back(choose(tagClass.cards, picked));
+        }
+    }
+
+    offset = depth * largestTag;
+    sums = 2 * offset + 1;
+    table.assign((classes.size() + 1) * (depth + 1) * sums, 0.0);
+    ways(0, 0, 0) = 1.0;
+    for (int index = 1; index <= (int) classes.size(); ++index) {
+        const TagClass& tagClass = classes[index - 1];
+        for (int dealt = 0; dealt <= depth; ++dealt) {
+            for (int tagSum = -offset; tagSum <= offset; ++tagSum) {
+                double before = ways(index - 1, dealt, tagSum);
+                if (before == 0.0) {
+                    continue;
+                }
+                for (int picked = 0; picked < (int) tagClass.choose.size() && dealt + picked <= depth; ++picked) {
+                    ways(index, dealt + picked, tagSum + tagClass.tag * picked) += before * tagClass.choose[picked];
+                }
+            }
+        }
+    }
+    total = choose(full.total, depth);
+    conditionOnTagSum(-offset, offset);
+
+    Deck deck;
+    deck.generateDeck();
+    for (int copy = 0; copy < decks; ++copy) {
+        cards.insert(cards.end(), deck.arrCards, deck.arrCards + 52);
+    }
+    std::stable_sort(cards.begin(), cards.end(),
+                     [](const Card& a, const Card& b) { return rankIndex(a) < rankIndex(b); });
+    for (int rank = 0, start = 0; rank < RANKS; start += full.counts[rank++]) {
+        rankStart[rank] = start;
+    }
+}
+
+
+bool ConditionalShoeSampler::conditionOnTagSum(int low, int high) {
+    fixedRemainder = false;
+    allowed.assign(sums, 0.0);
+    double sum = 0.0;
+    for (int tagSum = std::max(low, -offset); tagSum <= std::min(high, offset); ++tagSum) {
+        allowed[tagSum + offset] = ways((int) classes.size(), depth, tagSum);
+        sum += allowed[tagSum + offset];
+    }
+    if (sum == 0.0) {
+        conditionOnTagSum(-offset, offset);
+        return false;
+    }
+    chance = sum / total;
+    return true;
+}
+
+
+bool ConditionalShoeSampler::conditionOnTrueCount(double low, double high, int laterTags, int laterCards) {
+    // The true count rises with the tag sum, so the condition is a range of tag sums.
+    CardCounter counter(decks);
+    int initial = counter.runningCount(system) + laterTags;
+    double decksLeft = (full.total - depth - laterCards) / 52.0;
+    bool divides = deckTagSum(system) == 0 && decksLeft > 0.0;
+    int lowest = offset + 1;
+    int highest = -offset - 1;
+    for (int tagSum = -offset; tagSum <= offset; ++tagSum) {
+        double trueCount = divides ? (initial + tagSum) / decksLeft : initial + tagSum;
+        if (trueCount >= low && trueCount < high) {
+            lowest = std::min(lowest, tagSum);
+            highest = std::max(highest, tagSum);
+        }
+    }
+    return lowest <= highest && conditionOnTagSum(lowest, highest);
+}
+
+
+bool ConditionalShoeSampler::conditionOnRemainder(const ShoeComposition& remaining) {
+    if (remaining.total != full.total - depth) {
+        return false;
+    }
+    ShoeComposition dealt;
+    double product = 1.0;
+    for (int rank = 0; rank < RANKS; ++rank) {
+        if (remaining.counts[rank] < 0 || remaining.counts[rank] > full.counts[rank]) {
+            return false;
+        }
+        dealt.counts[rank] = full.counts[rank] - remaining.counts[rank];
+        dealt.total += dealt.counts[rank];
+        product *= choose(full.counts[rank], dealt.counts[rank]);
+    }
+    fixedRemainder = true;
+    fixedDealt = dealt;
+    chance = product / total;
+    return true;
+}
+
+
+ShoeComposition ConditionalShoeSampler::sampleDealt(std::mt19937& rng) const {
+    if (fixedRemainder) {
+        return fixedDealt;
+    }
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    // Pick the tag sum, then walk back through the classes choosing how many of each.
+    double target = unit(rng) * chance * total;
+    int tagSum = -offset;
+    for (; tagSum < offset; ++tagSum) {
+        target -= allowed[tagSum + offset];
+        if (target < 0.0 && allowed[tagSum + offset] > 0.0) {
+            break;
+        }
+    }
+    while (allowed[tagSum + offset] == 0.0) {
+        --tagSum; // rounding ran past the last allowed sum
+    }
+
+    ShoeComposition dealt;
+    int left = depth;
+    for (int index = (int) classes.size(); index > 0; --index) {
+        const TagClass& tagClass = classes[index - 1];
+        double weight = ways(index, left, tagSum);
+        double pick = unit(rng) * weight;
+        int picked = std::min((int) tagClass.choose.size() - 1, left);
+        for (int count = 0; count <= std::min((int) tagClass.choose.size() - 1, left); ++count) {
+            int before = tagSum - tagClass.tag * count;
+            if (before < -offset || before > offset) {
+                continue;
+            }
+            double share = ways(index - 1, left - count, before) * tagClass.choose[count];
+            pick -= share;
+            if (pick < 0.0 && share > 0.0) {
+                picked = count;
+                break;
+            }
+        }
+
+        // Split the class's cards between its ranks as a draw without replacement.
+        int pool[RANKS];
+        int poolSize = tagClass.cards;
+        for (int rank : tagClass.ranks) {
+            pool[rank] = full.counts[rank];
+        }
+        for (int card = 0; card < picked; ++card) {
+            int draw = std::uniform_int_distribution<int>(0, --poolSize)(rng);
+            for (int rank : tagClass.ranks) {
+                if (draw < pool[rank]) {
+                    --pool[rank];
+                    dealt.add(rank);
+                    break;
+                }
+                draw -= pool[rank];
+            }
+        }
+        left -= picked;
+        tagSum -= tagClass.tag * picked;
+    }
+    return dealt;
+}
+
+
+void ConditionalShoeSampler::deal(MultiDeck& shoe, std::mt19937& rng) const {
+    ShoeComposition dealt = sampleDealt(rng);
+    std::vector<Card> order(cards);
+    std::vector<Card> rest;
+    rest.reserve(order.size() - depth);
+    int front = 0;
+    for (int rank = 0; rank < RANKS; ++rank) {
+        auto begin = order.begin() + rankStart[rank];
+        std::shuffle(begin, begin + full.counts[rank], rng); // which suits and faces go
+        for (int card = 0; card < full.counts[rank]; ++card) {
+            if (card < dealt.counts[rank]) {
+                order[front++] = begin[card];
+            } else {
+                rest.push_back(begin[card]);
+            }
+        }
+    }
+    std::copy(rest.begin(), rest.end(), order.begin() + front);
+    std::shuffle(order.begin(), order.begin() + front, rng);
+    std::shuffle(order.begin() + front, order.end(), rng);
+
+    shoe.loadShoe(order);
+    for (int card = 0; card < depth; ++card) {
+        shoe.drawCard();
+    }
+}
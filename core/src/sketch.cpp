@@ -0,0 +1,60 @@
+#include "headers/sketch.h"
+
+#include <cmath>
+
+/**
+ * @file sketch.cpp
+ * @brief Bucket arithmetic of QuantileSketch.
+ */
+
+
+QuantileSketch::QuantileSketch(double relativeAccuracy, double minValue, double maxValue)
+    : gamma((1.0 + relativeAccuracy) / (1.0 - relativeAccuracy)), logGamma(std::log(gamma)), minValue(minValue) {
+    offset = (int) std::ceil(std::log(minValue) / logGamma);
+    int top = (int) std::ceil(std::log(maxValue) / logGamma);
+    buckets.assign(top - offset + 1, 0);
+}
+
+
+void QuantileSketch::add(double value) {
+    ++total;
+    if (!(value >= minValue)) {
+        ++zeros;
+        return;
+    }
+    int index = (int) std::ceil(std::log(value) / logGamma) - offset;
+    if (index >= (int) buckets.size()) {
+        index = (int) buckets.size() - 1;
+    }
+    ++buckets[index < 0 ? 0 : index];
+}
+
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    zeros += other.zeros;
+    total += other.total;
+    for (std::size_t i = 0; i < buckets.size() && i < other.buckets.size(); ++i) {
+        buckets[i] += other.buckets[i];
+    }
+}
+
+
+double QuantileSketch::quantile(double q) const {
+    if (total == 0) {
+        return 0.0;
+    }
+    // Rank of the wanted value among those added, counted from zero.
+    std::uint64_t rank = (std::uint64_t) (q * (total - 1));
+    if (rank < zeros) {
+        return 0.0;
+    }
+    std::uint64_t seen = zeros;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen > rank) {
+            // The midpoint of the bucket, in the sense that keeps the relative error bound.
+            return 2.0 * std::pow(gamma, (double) (int(i) + offset)) / (gamma + 1.0);
+        }
+    }
+    return 2.0 * std::pow(gamma, (double) (int(buckets.size()) - 1 + offset)) / (gamma + 1.0);
+}
@@ -0,0 +1,114 @@
+#include "headers/stats.h"
+
+#include <cmath>
+
+/**
+ * @file stats.cpp
+ * @brief Moment updates of RunningStats and RunningCovariance.
+ *
+ * add() and merge() use the one-pass update and pairwise combination formulas for central
+ * moments of Welford, Chan et al. and Pébay.
+ */
+
+
+void RunningStats::add(double value) {
+    std::uint64_t previous = n++;
+    double delta = value - average;
+    double deltaN = delta / n;
+    double deltaN2 = deltaN * deltaN;
+    double term = delta * deltaN * previous;
+    average += deltaN;
+    m4 += term * deltaN2 * (double(n) * n - 3.0 * n + 3.0) + 6.0 * deltaN2 * m2 - 4.0 * deltaN * m3;
+    m3 += term * deltaN * (n - 2.0) - 3.0 * deltaN * m2;
+    m2 += term;
+}
+
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.n == 0) {
+        return;
+    }
+    if (n == 0) {
+        *this = other;
+        return;
+    }
+    double a = (double) n;
+    double b = (double) other.n;
+    double total = a + b;
+    double delta = other.average - average;
+    double delta2 = delta * delta;
+    double delta3 = delta2 * delta;
+    double delta4 = delta2 * delta2;
+
+    double combined4 = m4 + other.m4 + delta4 * a * b * (a * a - a * b + b * b) / (total * total * total)
+        + 6.0 * delta2 * (a * a * other.m2 + b * b * m2) / (total * total)
+        + 4.0 * delta * (a * other.m3 - b * m3) / total;
+    double combined3 = m3 + other.m3 + delta3 * a * b * (a - b) / (total * total)
+        + 3.0 * delta * (a * other.m2 - b * m2) / total;
+    double combined2 = m2 + other.m2 + delta2 * a * b / total;
+
+    n += other.n;
+    average += delta * b / total;
+    m2 = combined2;
+    m3 = combined3;
+    m4 = combined4;
+}
+
+
+double RunningStats::standardDeviation() const {
+    return std::sqrt(variance());
+}
+
+
+double RunningStats::standardError() const {
+    return n > 1 ? std::sqrt(variance() / n) : 0.0;
+}
+
+
+double RunningStats::skewness() const {
+    return m2 > 0.0 ? std::sqrt((double) n) * m3 / std::pow(m2, 1.5) : 0.0;
+}
+
+
+double RunningStats::excessKurtosis() const {
+    return m2 > 0.0 ? n * m4 / (m2 * m2) - 3.0 : 0.0;
+}
+
+
+void RunningCovariance::add(double x, double y) {
+    ++n;
+    double deltaX = x - averageX;
+    averageX += deltaX / n;
+    double deltaY = y - averageY;
+    averageY += deltaY / n;
+    m2x += deltaX * (x - averageX);
+    m2y += deltaY * (y - averageY);
+    cxy += deltaX * (y - averageY);
+}
+
+
+void RunningCovariance::merge(const RunningCovariance& other) {
+    if (other.n == 0) {
+        return;
+    }
+    if (n == 0) {
+        *this = other;
+        return;
+    }
+    double a = (double) n;
+    double b = (double) other.n;
+    double total = a + b;
+    double deltaX = other.averageX - averageX;
+    double deltaY = other.averageY - averageY;
+    m2x += other.m2x + deltaX * deltaX * a * b / total;
+    m2y += other.m2y + deltaY * deltaY * a * b / total;
+    cxy += other.cxy + deltaX * deltaY * a * b / total;
+    averageX += deltaX * b / total;
+    averageY += deltaY * b / total;
+    n += other.n;
+}
+
+
+double RunningCovariance::correlation() const {
+    return m2x > 0.0 && m2y > 0.0 ? cxy / std::sqrt(m2x * m2y) : 0.0;
+}
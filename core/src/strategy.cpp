@@ -0,0 +1,155 @@
+#include "headers/strategy.h"
+
+/**
+ * @file strategy.cpp
+ * @brief Compile-time construction of the basic strategy tables.
+ *
+ * The charts below are multi-deck basic strategy for S17, DAS, with the dealer peeking. The
+ * other rule variants are derived from them by the well-known changes each rule makes, and
+ * all eight tables are built by constexpr functions, so none of this runs at start-up.
+ *
+ * Chart codes: H hit, S stand, P split, D double else hit, d double else stand,
+ * R surrender else hit, r surrender else stand, Q surrender else split.
+ */
+
+
+namespace {
+
+// Columns are the dealer upcard 2, 3, ..., 10, ace.
+constexpr const char *HARD_CHART[22] = {
+    "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", // 0-3, never dealt
+    "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", // 4-7
+    "HHHHHHHHHH", // 8
+    "HDDDDHHHHH", // 9
+    "DDDDDDDDHH", // 10
+    "DDDDDDDDDH", // 11
+    "HHSSSHHHHH", // 12
+    "SSSSSHHHHH", // 13
+    "SSSSSHHHHH", // 14
+    "SSSSSHHHRH", // 15
+    "SSSSSHHRRR", // 16
+    "SSSSSSSSSS", "SSSSSSSSSS", "SSSSSSSSSS", "SSSSSSSSSS", "SSSSSSSSSS" // 17-21
+};
+
+constexpr const char *SOFT_CHART[10] = {
+    "HHHHHHHHHH", // 12, a pair of aces that can no longer split
+    "HHHDDHHHHH", // 13
+    "HHHDDHHHHH", // 14
+    "HHDDDHHHHH", // 15
+    "HHDDDHHHHH", // 16
+    "HDDDDHHHHH", // 17
+    "SddddSSHHH", // 18
+    "SSSSSSSSSS", "SSSSSSSSSS", "SSSSSSSSSS" // 19-21
+};
+
+constexpr const char *PAIR_CHART[10] = {
+    "PPPPPPHHHH", // 2s
+    "PPPPPPHHHH", // 3s
+    "HHHPPHHHHH", // 4s
+    "DDDDDDDDHH", // 5s
+    "PPPPPHHHHH", // 6s
+    "PPPPPPHHHH", // 7s
+    "PPPPPPPPPP", // 8s
+    "PPPPPSPPSS", // 9s
+    "SSSSSSSSSS", // tens
+    "PPPPPPPPPP"  // aces
+};
+
+
+/// Chart code for a row and upcard under the given rules.
+constexpr char chartCode(bool hitSoft17, bool doubleAfterSplit, bool dealerPeek, int row, int upcard) {
+    int column = upcard - 2;
+    char code = row < softRow(12) ? HARD_CHART[row][column]
+              : row < pairRow(2) ? SOFT_CHART[row - softRow(12)][column]
+              : PAIR_CHART[row - pairRow(2)][column];
+
+    if (hitSoft17) {
+        if ((row == hardRow(11) && upcard == 11) || (row == softRow(18) && upcard == 2)
+            || (row == softRow(19) && upcard == 6)) {
+            code = code == 'S' ? 'd' : 'D';
+        }
+        if (row == hardRow(15) && upcard == 11) code = 'R';
+        if (row == hardRow(17) && upcard == 11) code = 'r';
+        if (row == pairRow(8) && upcard == 11) code = 'Q';
+    }
+    if (!doubleAfterSplit) {
+        // Without a double to follow, small pairs are only worth splitting against 4 to 7.
+        if ((row == pairRow(2) || row == pairRow(3)) && upcard <= 3) code = 'H';
+        if (row == pairRow(4)) code = 'H';
+        if (row == pairRow(6) && upcard == 2) code = 'H';
+    }
+    if (!dealerPeek) {
+        // Extra money put out against a ten or ace is lost to a dealer blackjack.
+        if (row == hardRow(11) && upcard >= 10) code = 'H';
+        if (row == pairRow(11) && upcard == 11) code = 'H';
+        if (row == pairRow(8) && upcard >= 10) code = 'R';
+    }
+    return code;
+}
+
+
+/// The action a chart code comes to when some options are not available.
+constexpr Action resolve(char code, bool canDouble, bool canSurrender) {
+    switch (code) {
+    case 'S': return ACTION_STAND;
+    case 'P': return ACTION_SPLIT;
+    case 'D': return canDouble ? ACTION_DOUBLE : ACTION_HIT;
+    case 'd': return canDouble ? ACTION_DOUBLE : ACTION_STAND;
+    case 'R': return canSurrender ? ACTION_SURRENDER : ACTION_HIT;
+    case 'r': return canSurrender ? ACTION_SURRENDER : ACTION_STAND;
+    case 'Q': return canSurrender ? ACTION_SURRENDER : ACTION_SPLIT;
+    default: return ACTION_HIT;
+    }
+}
+
+
+constexpr StrategyTable makeStrategyTable(bool hitSoft17, bool doubleAfterSplit, bool dealerPeek) {
+    StrategyTable table{};
+    for (int options = 0; options < 4; ++options) {
+        for (int row = 0; row < STRATEGY_ROWS; ++row) {
+            for (int upcard = 2; upcard <= 11; ++upcard) {
+                char code = chartCode(hitSoft17, doubleAfterSplit, dealerPeek, row, upcard);
+                table.action[options][row][upcard] = (unsigned char) resolve(code, options & 1, options & 2);
+            }
+        }
+    }
+    return table;
+}
+
+
+/// Indexed by 4 * hitSoft17 + 2 * doubleAfterSplit + dealerPeek.
+constexpr StrategyTable TABLES[8] = {
+    makeStrategyTable(false, false, false), makeStrategyTable(false, false, true),
+    makeStrategyTable(false, true, false),  makeStrategyTable(false, true, true),
+    makeStrategyTable(true, false, false),  makeStrategyTable(true, false, true),
+    makeStrategyTable(true, true, false),   makeStrategyTable(true, true, true),
+};
+
+constexpr int BOTH = 3, DOUBLE_ONLY = 1, NEITHER = 0;
+static_assert(TABLES[3].action[BOTH][hardRow(16)][10] == ACTION_SURRENDER, "S17 surrenders 16 v 10");
+static_assert(TABLES[3].action[DOUBLE_ONLY][hardRow(16)][10] == ACTION_HIT, "16 v 10 hits without surrender");
+static_assert(TABLES[3].action[NEITHER][softRow(18)][4] == ACTION_STAND, "soft 18 v 4 stands if it cannot double");
+static_assert(TABLES[3].action[BOTH][hardRow(11)][11] == ACTION_HIT, "S17 hits 11 v A");
+static_assert(TABLES[7].action[BOTH][hardRow(11)][11] == ACTION_DOUBLE, "H17 doubles 11 v A");
+static_assert(TABLES[2].action[BOTH][pairRow(8)][10] == ACTION_SURRENDER, "ENHC gives up 8,8 v 10");
+static_assert(TABLES[1].action[BOTH][pairRow(2)][2] == ACTION_HIT, "NDAS hits 2,2 v 2");
+
+} // namespace
+
+
+const StrategyTable& basicStrategyTable(const RuleSet& rules) {
+    return TABLES[4 * rules.hitSoft17 + 2 * rules.doubleAfterSplit + rules.dealerPeek];
+}
+
+
+IndexStrategy::IndexStrategy(const RuleSet& rules, const IndexTable& table)
+    : BasicStrategy(rules), plays(table.plays), insures(table.insures), insuranceIndex(table.insuranceIndex) {
+    for (auto& row : slots) {
+        for (signed char& slot : row) {
+            slot = -1;
+        }
+    }
+    for (std::size_t index = 0; index < plays.size() && index < 127; ++index) {
+        slots[plays[index].row][plays[index].upcard] = (signed char) index;
+    }
+}
@@ -0,0 +1,41 @@
+#include "headers/table.h"
+
+/**
+ * @file table.cpp
+ * @brief Implementation of the Table seat array.
+ */
+
+
+/**
+ * @brief Points every seat at the shoe and seats the first players.
+ * @param shoe The shoe all seats draw from.
+ * @param seatCount Number of seats in play to start with, clamped to 0 to MAX_SEATS.
+ */
+Table::Table(MultiDeck* shoe, int seatCount) {
+    for (player& seat : seats) {
+        seat.deck = shoe;
+    }
+    this->seatCount = seatCount < 0 ? 0 : (seatCount > MAX_SEATS ? MAX_SEATS : seatCount);
+}
+
+
+bool Table::addSeat() {
+    if (isFull()) {
+        return false;
+    }
+    seats[seatCount++].Reset();
+    return true;
+}
+
+
+void Table::clear() {
+    resetHands();
+    seatCount = 0;
+}
+
+
+void Table::resetHands() {
+    for (int i = 0; i < seatCount; ++i) {
+        seats[i].Reset();
+    }
+}
@@ -0,0 +1,167 @@
+#include "headers/trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @file trace.cpp
+ * @brief Implementation of per-thread span buffers and the Chrome trace writer.
+ *
+ * Each thread that records a span gets its own fixed-size event buffer the first time it
+ * records. Only the owning thread writes to it; the event count is published with a release
+ * store so the dump can read completed events without locking. A buffer that fills up stops
+ * recording and counts what it dropped. Buffers are kept for the life of the process, so
+ * spans from threads that have exited still appear in the dump.
+ */
+
+
+namespace tracing {
+
+std::atomic<bool> recording{false};
+
+namespace {
+
+constexpr std::size_t EVENTS_PER_THREAD = 1 << 16;
+
+/// One completed span.
+struct Event {
+    const char *name;
+    std::uint64_t startNs;
+    std::uint64_t endNs;
+};
+
+/// Span storage owned by a single recording thread.
+struct ThreadBuffer {
+    explicit ThreadBuffer(int threadId) : threadId(threadId), events(new Event[EVENTS_PER_THREAD]) {}
+
+    int threadId;
+    std::unique_ptr<Event[]> events;
+    std::atomic<std::size_t> count{0};
+    std::atomic<std::size_t> dropped{0};
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+/// Returns the calling thread's buffer, registering it on first use.
+ThreadBuffer& localBuffer() {
+    thread_local ThreadBuffer *buffer = nullptr;
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer((int) registry.size() + 1)));
+        buffer = registry.back().get();
+    }
+    return *buffer;
+}
+
+const char *traceFileFromEnvironment = nullptr;
+
+void writeTraceAtExit() {
+    writeChromeTrace(traceFileFromEnvironment);
+}
+
+} // namespace
+
+
+/// Monotonic timestamp used for span boundaries.
+std::uint64_t nowNanoseconds() {
+    return (std::uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/**
+ * @brief Appends a completed span to the calling thread's buffer.
+ * @param name Span name; must outlive the trace dump.
+ * @param startNs Start timestamp from nowNanoseconds().
+ * @param endNs End timestamp from nowNanoseconds().
+ */
+void record(const char *name, std::uint64_t startNs, std::uint64_t endNs) {
+    ThreadBuffer &buffer = localBuffer();
+    std::size_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index >= EVENTS_PER_THREAD) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[index] = Event{name, startNs, endNs};
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+
+/**
+ * @brief Turns span recording on or off at run time.
+ * @param enabled True to record spans.
+ */
+void setEnabled(bool enabled) {
+    recording.store(enabled, std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Enables tracing if the BJ_TRACE_FILE environment variable is set.
+ *
+ * The trace is then written to that path when the process exits.
+ */
+void startFromEnvironment() {
+    traceFileFromEnvironment = std::getenv("BJ_TRACE_FILE");
+    if (traceFileFromEnvironment != nullptr && traceFileFromEnvironment[0] != '\0') {
+        setEnabled(true);
+        std::atexit(writeTraceAtExit);
+    }
+}
+
+
+/**
+ * @brief Writes every recorded span as Chrome trace event JSON.
+ * @param path Output file path.
+ * @return True if the file was written successfully.
+ *
+ * Timestamps are relative to the earliest recorded span. Spans still being recorded by
+ * other threads while this runs may or may not be included.
+ */
+bool writeChromeTrace(const char *path) {
+    std::FILE *file = std::fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::uint64_t origin = UINT64_MAX;
+    for (const auto &buffer : registry) {
+        std::size_t count = buffer->count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (buffer->events[i].startNs < origin) {
+                origin = buffer->events[i].startNs;
+            }
+        }
+    }
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool first = true;
+    for (const auto &buffer : registry) {
+        std::size_t count = buffer->count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < count; ++i) {
+            const Event &event = buffer->events[i];
+            std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         first ? "" : ",\n", event.name, buffer->threadId,
+                         (event.startNs - origin) / 1000.0, (event.endNs - event.startNs) / 1000.0);
+            first = false;
+        }
+        std::size_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if (dropped > 0) {
+            std::fprintf(file, "%s{\"name\":\"dropped %zu spans\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":0}",
+                         first ? "" : ",\n", dropped, buffer->threadId);
+            first = false;
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+
+    return std::fclose(file) == 0;
+}
+
+} // namespace tracing
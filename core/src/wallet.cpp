@@ -1,4 +1,5 @@
 #include "headers/wallet.h"
+#include "headers/metrics.h"
 
 
 /**
@@ -28,6 +29,7 @@ wallet::wallet() {
     //    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // discard the input
     //}
     balance = initialBalance;
+    metrics::walletBalance.set(balance);
 }
 
 /**
@@ -51,6 +53,7 @@ double wallet::getBalance() const {
 void wallet::addFunds(double amount) {
     if (amount > 0) {
         balance += amount;
+        metrics::walletBalance.set(balance);
         //std::cout << "Added funds. New balance: " << balance << std::endl;
     }
 }
@@ -66,6 +69,7 @@ void wallet::addFunds(double amount) {
 void wallet::startingBal(double amount) {
     if (amount > 0) {
         balance = amount;
+        metrics::walletBalance.set(balance);
         //std::cout << "Starting balance set to: " << balance << std::endl;
     }
 }
@@ -84,6 +88,7 @@ void wallet::startingBal(double amount) {
 bool wallet::placeBet(double betAmount) {
     if (betAmount > 0 && betAmount <= balance) {
         balance -= betAmount;
+        metrics::walletBalance.set(balance);
         // std::cout << "Bet placed: " << betAmount << ". New balance: " << balance << std::endl;
         return true;
     } else {
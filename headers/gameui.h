@@ -2,9 +2,12 @@
 #define GAMEUI_H
 
 #include "headers/wallet.h"
+#include "headers/advisor.h"
 #include "headers/DeckSetup.h"
 #include "headers/player.h"
 #include "headers/dealer.h"
+#include "headers/rules.h"
+#include "headers/table.h"
 #include <QWidget>
 #include <QLabel>
 #include <QPushButton>
@@ -57,6 +60,10 @@ public:
 
     MultiDeck multideck;
 
+    RuleSet rules; /// Table rules; the defaults are six decks, S17, blackjack pays 3:2.
+
+    Table table; /// The seats in play, filled from seat 0 as players are added.
+
     // void clearCardDisplays();
 
 private:
@@ -66,8 +73,6 @@ private:
 
     bool setupComplete;
 
-    int skiphand = -1; /// Used to skip a hand if necessary.
-
     QHBoxLayout *buttonsLayout;
 
 
@@ -75,17 +80,9 @@ private:
 
     QList<QLabel*> dealerHandImages;
 
-    player *player1;
-    player *player2;
-    player *player3;
-
     dealer *dealer;
 
-    QList<player*> players; /// List of player instances. Used to access player info
-
-    int playerNum = 0;
-
-    int currentPlayingHand = 0;
+    int currentPlayingHand = 0; /// Index of the seat whose turn it is.
 
     int setupNum = 0;
 
@@ -97,15 +94,14 @@ private:
     QPushButton *hitButton;
     QPushButton *standButton;
     QPushButton *doubleButton;
+    QPushButton *splitButton;
 
 
     QPushButton *endHandButton;
     QPushButton *backToMenu;
 
 
-    QPushButton *addPlayer1;
-    QPushButton *addPlayer2;
-    QPushButton *addPlayer3;
+    QPushButton *addPlayerButton;
 
 
     QLabel *enter_bet_amount_label;
@@ -115,17 +111,32 @@ private:
     wallet *myWallet;
     QLabel *walletLabel;
     QTextBrowser* wallet_status;
-    QLabel *playerHandValue1;
+    QLabel *seatHandValues[MAX_SEATS]; /// Hand values shown under each seat.
 
 
     QLabel *dealerHandValue;
 
+    Advisor *advisor;             /// Works out the action values shown in adviceLabel.
+    QLabel *adviceLabel;          /// Expected value of each action on the hand being played.
+    CompositionKey adviceKey{};   /// The situation adviceLabel should describe.
+
     Deck *myDeck;
     MultiDeck *myMultiDeck;
 
     void set_table_background();
     void updateSliderRange();
     void updateWalletBalanceLabel();
+    int seatX(int seat) const;
+    void moveButtonsToSeat(int seat);
+    void drawPlayerHand(int seat, int handIndex);
+    void updateActionButtons();
+    AdvisorQuery currentQuery() const;
+    void requestAdvice();
+    void showAdvice(const ActionValues &values);
+    void clearAdvice();
+    void countHoleCard();
+
+    bool holeCardCounted = true; /// False while the dealer's hole card is face down.
 
     bool isDoubleDown = false;
 
@@ -138,6 +149,7 @@ private slots:
 
     void onBackClicked();
     void onDoubleClicked();
+    void onSplitClicked();
 
     void onShowDeckClicked();
     void onHitClicked();
@@ -152,9 +164,7 @@ private slots:
     void delay(int milliseconds);
 
 
-    void onAddPlayer1Clicked();
-    void onAddPlayer2Clicked();
-    void onAddPlayer3Clicked();
+    void onAddPlayerClicked();
 
     void showPlayerActionButtons();
     void hidePlayerActionButtons();
@@ -162,8 +172,10 @@ private slots:
     void displayPlayerHandsValue();
 
     void checkBJ();
+    void offerInsurance();
 
     void endHand();
+    void finishRound();
 
 
 
@@ -0,0 +1,24 @@
+#ifndef QTADAPTER_H
+#define QTADAPTER_H
+
+#include <QString>
+#include "headers/DeckSetup.h"
+#include "headers/handvalue.h"
+
+/**
+ * @file qtadapter.h
+ * @brief Qt presentation helpers for the core game types.
+ *
+ * The core library has no Qt dependency, so everything the GUI needs to display a card or a
+ * hand total as a QString is collected here.
+ */
+
+
+QString cardText(const Card& card);        /// e.g. "Queen of Hearts".
+QString cardImagePath(const Card& card);   /// Resource path of the card's image.
+
+QString playerHandText(const HandValue& value);
+QString dealerHandText(const HandValue& value);
+
+
+#endif // QTADAPTER_H
@@ -0,0 +1,57 @@
+#include "commands.h"
+#include "headers/analyzer.h"
+#include "headers/composition.h"
+#include "headers/rules.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @file analyze.cpp
+ * @brief The analyze command: exact expected value of a round off the top of the shoe.
+ *
+ * Usage: bjsim analyze [--threads N] [rule options]. Prints the expected value against
+ * each upcard and for the whole round under composition-dependent optimal play, which is
+ * the house edge a simulation should converge to with perfect play.
+ */
+
+
+namespace {
+
+const char *UPCARD_NAMES[RANKS] = { "A", "2", "3", "4", "5", "6", "7", "8", "9", "T" };
+
+} // namespace
+
+
+int runAnalyze(int argc, char *argv[]) {
+    RuleSet rules;
+    int threads = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+            continue;
+        }
+        int consumed = parseRuleOption(rules, argc, argv, i);
+        if (consumed <= 0) {
+            printUsage();
+            return 2;
+        }
+        i += consumed - 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ShoeComposition shoe = ShoeComposition::fullShoe(rules.decks);
+    AnalysisReport report = analyzeShoe(rules, shoe, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("rules: %s\n", rules.describe().c_str());
+    std::printf("up   chance       ev\n");
+    for (int upcard = 0; upcard < RANKS; ++upcard) {
+        std::printf("%-4s %6.4f %+8.5f\n", UPCARD_NAMES[upcard], shoe.probability(upcard), report.upcardValue[upcard]);
+    }
+    std::printf("expected value per round: %+.4f%%\n", report.expectedValue * 100.0);
+    std::printf("elapsed: %.3f s\n", seconds);
+    return 0;
+}
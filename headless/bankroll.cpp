@@ -0,0 +1,245 @@
+#include "commands.h"
+#include "headers/DeckSetup.h"
+#include "headers/betting.h"
+#include "headers/engine.h"
+#include "headers/rules.h"
+#include "headers/sketch.h"
+#include "headers/strategy.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * @file bankroll.cpp
+ * @brief The bankroll command: risk of ruin and bankroll trajectories.
+ *
+ * Usage: bjsim bankroll [--paths N] [--rounds N] [--bankroll U] [--stop-win U]
+ * [--stop-loss U] [--checkpoints N] [--ramp RAMP] [--count SYSTEM] [--threads N] [--seed S]
+ * [rule options].
+ *
+ * Plays many independent sessions of up to --rounds rounds, each starting from the same
+ * bankroll and betting off the ramp with count-based insurance. Every session starts on a
+ * fresh shoe shuffled from streamSeed(S, session), so sessions do not share a count and a
+ * run is repeated exactly by giving the seed it printed. A session ends early when the
+ * balance can no longer cover the next bet or a round leaves nothing (ruin, with the balance
+ * held at zero), or reaches the stop-win or stop-loss level. The balance of every session
+ * is recorded at evenly spaced checkpoints, a finished session keeping its final balance,
+ * in one QuantileSketch per checkpoint, so memory stays the same however many sessions are
+ * played.
+ */
+
+
+namespace {
+
+/// What a run of sessions is asked to do.
+struct SessionOptions {
+    long paths = 100000;
+    long rounds = 1000;       /// Most rounds in one session.
+    double bankroll = 1000.0; /// Starting balance, in units.
+    double stopWin = 0.0;     /// Stop once this much up; 0 for never.
+    double stopLoss = 0.0;    /// Stop once this much down; 0 for never.
+    int checkpoints = 10;
+};
+
+/// Outcome counts and sketches over a set of sessions.
+struct SessionResult {
+    long paths = 0;
+    long ruined = 0;
+    long stoppedWin = 0;
+    long stoppedLoss = 0;
+    long doubled = 0;
+    QuantileSketch timeToDouble;
+    QuantileSketch timeToRuin;
+    std::vector<QuantileSketch> balances; /// One per checkpoint.
+
+    explicit SessionResult(int checkpoints = 0) : balances(checkpoints) {}
+
+    void merge(const SessionResult& other) {
+        paths += other.paths;
+        ruined += other.ruined;
+        stoppedWin += other.stoppedWin;
+        stoppedLoss += other.stoppedLoss;
+        doubled += other.doubled;
+        timeToDouble.merge(other.timeToDouble);
+        timeToRuin.merge(other.timeToRuin);
+        for (std::size_t i = 0; i < balances.size(); ++i) {
+            balances[i].merge(other.balances[i]);
+        }
+    }
+};
+
+/// Round after which checkpoint index is taken, counting from one.
+long checkpointRound(const SessionOptions& options, int index) {
+    return options.rounds * (index + 1) / options.checkpoints;
+}
+
+/// Plays every stride-th session from first, each on its own freshly shuffled shoe.
+template <class Rules>
+SessionResult playSessions(const Rules& rules, const CountingStrategy& strategy, const BetRamp& ramp,
+                           const SessionOptions& options, CountingSystem system, std::uint64_t seed, long first,
+                           long stride) {
+    MultiDeck shoe(rules.decks());
+    Engine<Rules> engine(rules, shoe);
+    engine.setCountingSystem(system);
+
+    SessionResult result(options.checkpoints);
+    for (long path = first; path < options.paths; path += stride) {
+        ++result.paths;
+        shoe.seed(streamSeed(seed, path));
+        shoe.createAndShuffleDecks();
+        double balance = options.bankroll;
+        bool doubled = false;
+        int checkpoint = 0;
+        for (long round = 1; round <= options.rounds; ++round) {
+            double bet = ramp.bet(engine.trueCount(), balance);
+            if (bet > balance) {
+                ++result.ruined;
+                result.timeToRuin.add(round);
+                balance = 0.0;
+                break;
+            }
+            balance += engine.playRound(strategy, bet);
+            if (balance <= 0.0) {
+                // A lost double or split can take more than the bet.
+                ++result.ruined;
+                result.timeToRuin.add(round);
+                balance = 0.0;
+                break;
+            }
+            if (!doubled && balance >= 2.0 * options.bankroll) {
+                doubled = true;
+                ++result.doubled;
+                result.timeToDouble.add(round);
+            }
+            while (checkpoint < options.checkpoints && checkpointRound(options, checkpoint) == round) {
+                result.balances[checkpoint++].add(balance);
+            }
+            if (options.stopWin > 0.0 && balance >= options.bankroll + options.stopWin) {
+                ++result.stoppedWin;
+                break;
+            }
+            if (options.stopLoss > 0.0 && balance <= options.bankroll - options.stopLoss) {
+                ++result.stoppedLoss;
+                break;
+            }
+        }
+        // A finished session holds its balance for the checkpoints it did not reach.
+        while (checkpoint < options.checkpoints) {
+            result.balances[checkpoint++].add(balance);
+        }
+    }
+    return result;
+}
+
+template <class Rules>
+SessionResult simulateSessions(const Rules& rules, const CountingStrategy& strategy, const BetRamp& ramp,
+                               const SessionOptions& options, CountingSystem system, std::uint64_t seed,
+                               int threads) {
+    std::vector<SessionResult> partial(threads, SessionResult(options.checkpoints));
+    std::vector<std::thread> workers;
+    for (int index = 0; index < threads; ++index) {
+        workers.emplace_back([&, index] {
+            partial[index] = playSessions(rules, strategy, ramp, options, system, seed, index, threads);
+        });
+    }
+
+    SessionResult result(options.checkpoints);
+    for (int index = 0; index < threads; ++index) {
+        workers[index].join();
+        result.merge(partial[index]);
+    }
+    return result;
+}
+
+double percent(long part, long whole) {
+    return whole > 0 ? 100.0 * part / whole : 0.0;
+}
+
+} // namespace
+
+
+int runBankroll(int argc, char *argv[]) {
+    SessionOptions options;
+    RuleSet rules;
+    BetRamp ramp;
+    CountingSystem system = COUNT_HI_LO;
+    int threads = 1;
+    std::uint64_t seed = std::random_device{}();
+    for (int i = 1; i < argc; ++i) {
+        int consumed = parseRuleOption(rules, argc, argv, i);
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (consumed > 0) {
+            i += consumed - 1;
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--paths") == 0 && std::atol(value) > 0) {
+            options.paths = std::atol(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--rounds") == 0 && std::atol(value) > 0) {
+            options.rounds = std::atol(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--bankroll") == 0 && std::atof(value) > 0) {
+            options.bankroll = std::atof(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--stop-win") == 0) {
+            options.stopWin = std::atof(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--stop-loss") == 0) {
+            options.stopLoss = std::atof(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--checkpoints") == 0 && std::atoi(value) > 0) {
+            options.checkpoints = std::atoi(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--ramp") == 0 && parseBetRamp(value, ramp)) {
+            ++i;
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--count") == 0 && parseCountingSystem(value, system)) {
+            ++i;
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--threads") == 0 && std::atoi(value) > 0) {
+            threads = std::atoi(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--seed") == 0) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (!ramp.setCountingSystem(system)) {
+        std::fprintf(stderr, "bjsim: a kelly ramp needs a balanced count, not %s\n", CardCounter::systemName(system));
+        return 2;
+    }
+    if (options.checkpoints > options.rounds) {
+        options.checkpoints = (int) options.rounds;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    CountingStrategy strategy(rules);
+    SessionResult result = withRules(rules, [&](const auto& policy) {
+        return simulateSessions(policy, strategy, ramp, options, system, seed, threads);
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("rules: %s\n", rules.describe().c_str());
+    std::printf("count: %s\n", CardCounter::systemName(system));
+    std::printf("ramp: %s\n", ramp.describe().c_str());
+    std::printf("sessions: %ld of up to %ld rounds from %.0f units, seed %llu\n", result.paths, options.rounds,
+                options.bankroll, (unsigned long long) seed);
+    std::printf("risk of ruin: %.3f%%\n", percent(result.ruined, result.paths));
+    if (result.ruined > 0) {
+        std::printf("  rounds to ruin: median %.0f, 10%% by %.0f\n", result.timeToRuin.quantile(0.5),
+                    result.timeToRuin.quantile(0.1));
+    }
+    std::printf("stop-win reached: %.3f%%, stop-loss reached: %.3f%%\n", percent(result.stoppedWin, result.paths),
+                percent(result.stoppedLoss, result.paths));
+    std::printf("doubled: %.3f%%\n", percent(result.doubled, result.paths));
+    if (result.doubled > 0) {
+        std::printf("  rounds to double: median %.0f, 90%% by %.0f\n", result.timeToDouble.quantile(0.5),
+                    result.timeToDouble.quantile(0.9));
+    }
+
+    std::printf("   round         p5        p25        p50        p75        p95\n");
+    for (int index = 0; index < options.checkpoints; ++index) {
+        const QuantileSketch& balances = result.balances[index];
+        std::printf("%8ld %10.1f %10.1f %10.1f %10.1f %10.1f\n", checkpointRound(options, index),
+                    balances.quantile(0.05), balances.quantile(0.25), balances.quantile(0.5),
+                    balances.quantile(0.75), balances.quantile(0.95));
+    }
+    std::printf("elapsed: %.3f s\n", seconds);
+    return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef COMMANDS_H
+#define COMMANDS_H
+
+/**
+ * @file commands.h
+ * @brief The bjsim subcommands.
+ *
+ * Each command gets the arguments after the program name, so argv[0] is the command's own
+ * name, parses its options (rule options through parseRuleOption()) and returns the exit
+ * status.
+ */
+
+
+int runSimulate(int argc, char *argv[]);
+int runDealerOdds(int argc, char *argv[]);
+int runAnalyze(int argc, char *argv[]);
+int runBankroll(int argc, char *argv[]);
+int runCompare(int argc, char *argv[]);
+int runConditional(int argc, char *argv[]);
+int runIndices(int argc, char *argv[]);
+int runEffectsOfRemoval(int argc, char *argv[]);
+int runSweep(int argc, char *argv[]);
+
+/// Prints the usage of every command to stderr.
+void printUsage();
+
+
+#endif // COMMANDS_H
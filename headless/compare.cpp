@@ -0,0 +1,324 @@
+#include "commands.h"
+#include "headers/DeckSetup.h"
+#include "headers/betting.h"
+#include "headers/engine.h"
+#include "headers/rules.h"
+#include "headers/stats.h"
+#include "headers/strategy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file compare.cpp
+ * @brief The compare command: several variants played on the same shoes.
+ *
+ * Usage: bjsim compare [--shoes N] [--seed S] [--threads N] VARIANT [-- VARIANT ...], where
+ * each VARIANT is any of [--strategy basic|dealer|count] [--count SYSTEM] [--ramp RAMP]
+ * [rule options]. The first variant is the baseline.
+ *
+ * Every shoe is shuffled once and then dealt to each variant in turn, each from a fresh copy
+ * of the same order down to its own cut card, so the variants see identical cards and their
+ * luck largely cancels when they are compared (common random numbers). Each variant's result
+ * is its total net over its total rounds, and the difference from the baseline is the
+ * difference of those ratios. Shoes are the independent units, so both get delta-method
+ * variances from per-shoe nets and round counts, which stay right when variants play
+ * different numbers of rounds from a shoe. The report gives the difference's 95% interval
+ * next to the one independent runs of the same length would have had. Variants must use the same number of
+ * decks; rules, strategy, count and ramp may all differ.
+ */
+
+
+namespace {
+
+/// What one variant plays.
+struct Variant {
+    RuleSet rules;
+    const char *strategyName = "basic";
+    CountingSystem system = COUNT_HI_LO;
+    BetRamp ramp;
+
+    std::string describe() const {
+        return std::string(strategyName) + ", " + rules.describe() + ", " + ramp.describe();
+    }
+};
+
+/// A variant's result on one shoe.
+struct ShoeResult {
+    long rounds = 0;
+    double net = 0.0;
+};
+
+
+/**
+ * @class VariantPlayer
+ * @brief Plays one variant, with its own engine, on shoes shuffled elsewhere.
+ */
+class VariantPlayer {
+public:
+    virtual ~VariantPlayer() = default;
+
+    /// Plays rounds on a copy of the order until the variant's cut card.
+    virtual ShoeResult playShoe(const std::vector<Card>& order) = 0;
+};
+
+
+template <class Rules, class Strategy>
+class EnginePlayer : public VariantPlayer {
+public:
+    EnginePlayer(const Rules& rules, const Strategy& strategy, const Variant& variant)
+        : strategy(strategy), ramp(variant.ramp), shoe(rules.decks()), engine(rules, shoe) {
+        engine.setCountingSystem(variant.system);
+    }
+
+    ShoeResult playShoe(const std::vector<Card>& order) override {
+        shoe.loadShoe(order);
+        ShoeResult result;
+        while (!shoe.needsShuffle(engine.ruleSet().penetration())) {
+            result.net += engine.playRound(strategy, ramp.bet(engine.trueCount()));
+            ++result.rounds;
+        }
+        return result;
+    }
+
+private:
+    Strategy strategy;
+    BetRamp ramp;
+    MultiDeck shoe;
+    Engine<Rules> engine;
+};
+
+
+std::unique_ptr<VariantPlayer> makePlayer(const Variant& variant) {
+    return withRules(variant.rules, [&](const auto& policy) -> std::unique_ptr<VariantPlayer> {
+        using Rules = std::decay_t<decltype(policy)>;
+        if (std::strcmp(variant.strategyName, "dealer") == 0) {
+            return std::make_unique<EnginePlayer<Rules, MimicDealerStrategy>>(policy, MimicDealerStrategy(), variant);
+        } else if (std::strcmp(variant.strategyName, "count") == 0) {
+            return std::make_unique<EnginePlayer<Rules, CountingStrategy>>(policy, CountingStrategy(variant.rules),
+                                                                           variant);
+        }
+        return std::make_unique<EnginePlayer<Rules, BasicStrategy>>(policy, BasicStrategy(variant.rules), variant);
+    });
+}
+
+
+/**
+ * @struct ShoeRatio
+ * @brief One variant's net per round over many shoes, as a ratio of per-shoe totals.
+ *
+ * Keeps the covariances of the variant's per-shoe rounds and net, and of those against the
+ * baseline's, so the ratio's variance and that of its difference from the baseline's ratio
+ * follow by the delta method.
+ */
+struct ShoeRatio {
+    RunningCovariance own;          /// x rounds, y net.
+    RunningCovariance netNet;       /// x the baseline's net, y this variant's net.
+    RunningCovariance roundsNet;    /// x the baseline's rounds, y this variant's net.
+    RunningCovariance netRounds;    /// x the baseline's net, y this variant's rounds.
+    RunningCovariance roundsRounds; /// x the baseline's rounds, y this variant's rounds.
+
+    void add(const ShoeResult& shoe, const ShoeResult& baseline) {
+        own.add(shoe.rounds, shoe.net);
+        netNet.add(baseline.net, shoe.net);
+        roundsNet.add(baseline.rounds, shoe.net);
+        netRounds.add(baseline.net, shoe.rounds);
+        roundsRounds.add(baseline.rounds, shoe.rounds);
+    }
+
+    void merge(const ShoeRatio& other) {
+        own.merge(other.own);
+        netNet.merge(other.netNet);
+        roundsNet.merge(other.roundsNet);
+        netRounds.merge(other.netRounds);
+        roundsRounds.merge(other.roundsRounds);
+    }
+
+    double ratio() const { return own.meanX() > 0.0 ? own.meanY() / own.meanX() : 0.0; }
+
+    /// Variance of one shoe's net less ratio() times its rounds, over the mean rounds.
+    double residualVariance() const {
+        double r = ratio();
+        double rounds = own.meanX();
+        return rounds > 0.0
+            ? (own.varianceY() - 2.0 * r * own.covariance() + r * r * own.varianceX()) / (rounds * rounds) : 0.0;
+    }
+
+    /// Half-width of the 95% interval of ratio().
+    double halfWidth() const {
+        return CONFIDENCE_95 * std::sqrt(std::max(0.0, residualVariance()) / std::max<std::uint64_t>(own.count(), 1));
+    }
+
+    /// Covariance of this variant's per-shoe residual with the baseline's.
+    double residualCovariance(const ShoeRatio& baseline) const {
+        double r = ratio();
+        double b = baseline.ratio();
+        double scale = own.meanX() * baseline.own.meanX();
+        return scale > 0.0 ? (netNet.covariance() - b * roundsNet.covariance() - r * netRounds.covariance()
+                              + r * b * roundsRounds.covariance()) / scale : 0.0;
+    }
+};
+
+
+/// Per-variant totals and ratios.
+struct CompareResult {
+    std::vector<long> rounds;
+    std::vector<double> net;
+    std::vector<ShoeRatio> ratios;
+
+    explicit CompareResult(std::size_t variants = 0) : rounds(variants), net(variants), ratios(variants) {}
+
+    void merge(const CompareResult& other) {
+        for (std::size_t index = 0; index < rounds.size(); ++index) {
+            rounds[index] += other.rounds[index];
+            net[index] += other.net[index];
+            ratios[index].merge(other.ratios[index]);
+        }
+    }
+};
+
+
+/// Shuffles shoes from one seeded stream and plays every variant on each of them.
+CompareResult compareShoes(const std::vector<Variant>& variants, long shoes, std::uint64_t seed) {
+    std::vector<std::unique_ptr<VariantPlayer>> players;
+    for (const Variant& variant : variants) {
+        players.push_back(makePlayer(variant));
+    }
+    MultiDeck master(variants[0].rules.decks);
+    master.seed(seed);
+
+    CompareResult result(variants.size());
+    std::vector<ShoeResult> played(variants.size());
+    for (long index = 0; index < shoes; ++index) {
+        master.createAndShuffleDecks();
+        for (std::size_t variant = 0; variant < variants.size(); ++variant) {
+            played[variant] = players[variant]->playShoe(master.allDecks);
+            result.rounds[variant] += played[variant].rounds;
+            result.net[variant] += played[variant].net;
+            result.ratios[variant].add(played[variant], played[0]);
+        }
+    }
+    return result;
+}
+
+
+/// Parses one variant's options from argv[first] up to the next "--"; returns the index
+/// after them, or -1 if an option is invalid.
+int parseVariant(int argc, char *argv[], int first, Variant& variant) {
+    int i = first;
+    for (; i < argc && std::strcmp(argv[i], "--") != 0; ++i) {
+        int consumed = parseRuleOption(variant.rules, argc, argv, i);
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (consumed > 0) {
+            i += consumed - 1;
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--strategy") == 0
+                   && (std::strcmp(value, "basic") == 0 || std::strcmp(value, "dealer") == 0
+                       || std::strcmp(value, "count") == 0)) {
+            variant.strategyName = argv[++i];
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--count") == 0
+                   && parseCountingSystem(value, variant.system)) {
+            ++i;
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--ramp") == 0 && parseBetRamp(value, variant.ramp)) {
+            ++i;
+        } else {
+            return -1;
+        }
+    }
+    return i;
+}
+
+} // namespace
+
+
+int runCompare(int argc, char *argv[]) {
+    long shoes = 10000;
+    std::uint64_t seed = std::random_device{}();
+    int threads = 1;
+    int i = 1;
+    for (; i < argc; ++i) {
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value && std::strcmp(argv[i], "--shoes") == 0 && std::atol(value) > 0) {
+            shoes = std::atol(argv[++i]);
+        } else if (value && std::strcmp(argv[i], "--seed") == 0) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (value && std::strcmp(argv[i], "--threads") == 0 && std::atoi(value) > 0) {
+            threads = std::atoi(argv[++i]);
+        } else {
+            break;
+        }
+    }
+
+    std::vector<Variant> variants;
+    while (i <= argc) {
+        Variant variant;
+        i = parseVariant(argc, argv, i, variant);
+        if (i < 0) {
+            printUsage();
+            return 2;
+        }
+        variants.push_back(variant);
+        ++i; // past the "--"
+    }
+    for (const Variant& variant : variants) {
+        if (variant.rules.decks != variants[0].rules.decks) {
+            std::fprintf(stderr, "bjsim: compared variants must use the same number of decks\n");
+            return 2;
+        }
+    }
+    for (Variant& variant : variants) {
+        if (!variant.ramp.setCountingSystem(variant.system)) {
+            std::fprintf(stderr, "bjsim: a kelly ramp needs a balanced count, not %s\n",
+                         CardCounter::systemName(variant.system));
+            return 2;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<CompareResult> partial(threads, CompareResult(variants.size()));
+    std::vector<std::thread> workers;
+    for (int index = 0; index < threads; ++index) {
+        long share = shoes / threads + (index < shoes % threads ? 1 : 0);
+        workers.emplace_back([&, index, share] {
+            partial[index] = compareShoes(variants, share, streamSeed(seed, index));
+        });
+    }
+    CompareResult result(variants.size());
+    for (int index = 0; index < threads; ++index) {
+        workers[index].join();
+        result.merge(partial[index]);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("shoes: %ld, seed %llu\n", shoes, (unsigned long long) seed);
+    for (std::size_t index = 0; index < variants.size(); ++index) {
+        long rounds = result.rounds[index];
+        std::printf("%zu: %s\n", index + 1, variants[index].describe().c_str());
+        std::printf("   rounds %ld, net units per round %+.5f +/- %.5f (95%%, per shoe)\n", rounds,
+                    rounds > 0 ? result.net[index] / rounds : 0.0, result.ratios[index].halfWidth());
+    }
+    std::printf("difference from 1, per round, with common shoes and as independent runs:\n");
+    const ShoeRatio& baseline = result.ratios[0];
+    double count = (double) std::max<std::uint64_t>(baseline.own.count(), 1);
+    for (std::size_t index = 1; index < variants.size(); ++index) {
+        const ShoeRatio& variant = result.ratios[index];
+        double separate = variant.residualVariance() + baseline.residualVariance();
+        double paired = CONFIDENCE_95 * std::sqrt(std::max(0.0, separate - 2.0 * variant.residualCovariance(baseline))
+                                                  / count);
+        double independent = CONFIDENCE_95 * std::sqrt(std::max(0.0, separate) / count);
+        std::printf("%zu: %+.5f +/- %.5f  (independent +/- %.5f, %.1fx fewer shoes needed)\n", index + 1,
+                    variant.ratio() - baseline.ratio(), paired, independent,
+                    paired > 0.0 ? (independent * independent) / (paired * paired) : 0.0);
+    }
+    std::printf("elapsed: %.3f s\n", seconds);
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "commands.h"
+#include "headers/DeckSetup.h"
+#include "headers/engine.h"
+#include "headers/rules.h"
+#include "headers/sampler.h"
+#include "headers/stats.h"
+#include "headers/strategy.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+/**
+ * @file conditional.cpp
+ * @brief The conditional command: results at chosen true counts, without waiting for them.
+ *
+ * Usage: bjsim conditional [--depth F] [--from T] [--to T] [--rounds N] [--count SYSTEM]
+ * [--strategy basic|count] [--seed S] [rule options].
+ *
+ * For every whole true count T from --from to --to, deals --rounds shoes with a fraction F
+ * of the cards already gone and the true count in [T, T + 1), using ConditionalShoeSampler,
+ * and plays one round from each. Each bin is reported with the chance a shuffled shoe is in
+ * it at that depth, and the bins are then combined with those chances as weights, which is
+ * what plain simulation at that depth would give over the same range of counts.
+ */
+
+
+namespace {
+
+/// Plays one round on each of a number of shoes drawn from the sampler.
+template <class Rules, class Strategy>
+RunningStats playConditioned(const Rules& rules, const Strategy& strategy, const ConditionalShoeSampler& sampler,
+                             CountingSystem system, long rounds, std::mt19937& rng) {
+    MultiDeck shoe(rules.decks());
+    Engine<Rules> engine(rules, shoe);
+    engine.setCountingSystem(system);
+    RunningStats results;
+    for (long round = 0; round < rounds; ++round) {
+        sampler.deal(shoe, rng);
+        results.add(engine.playRound(strategy));
+    }
+    return results;
+}
+
+} // namespace
+
+
+int runConditional(int argc, char *argv[]) {
+    RuleSet rules;
+    double depth = 0.5;
+    int from = -5;
+    int to = 10;
+    long rounds = 100000;
+    CountingSystem system = COUNT_HI_LO;
+    const char *strategyName = "basic";
+    std::uint64_t seed = std::random_device{}();
+    for (int i = 1; i < argc; ++i) {
+        int consumed = parseRuleOption(rules, argc, argv, i);
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (consumed > 0) {
+            i += consumed - 1;
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--depth") == 0 && std::atof(value) >= 0.0) {
+            depth = std::atof(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--from") == 0) {
+            from = std::atoi(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--to") == 0) {
+            to = std::atoi(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--rounds") == 0 && std::atol(value) > 0) {
+            rounds = std::atol(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--count") == 0 && parseCountingSystem(value, system)) {
+            ++i;
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--strategy") == 0
+                   && (std::strcmp(value, "basic") == 0 || std::strcmp(value, "count") == 0)) {
+            strategyName = argv[++i];
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--seed") == 0) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    int cardsDealt = (int) (depth * rules.decks * 52);
+    if (depth >= rules.penetration) {
+        std::fprintf(stderr, "bjsim: --depth must be before the cut card (%.2f)\n", rules.penetration);
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ConditionalShoeSampler sampler(rules.decks, system, cardsDealt);
+    std::mt19937 rng;
+    std::seed_seq sequence{(unsigned) (seed & 0xffffffffU), (unsigned) (seed >> 32)};
+    rng.seed(sequence);
+    BasicStrategy basic(rules);
+    CountingStrategy counting(rules);
+
+    std::printf("rules: %s\n", rules.describe().c_str());
+    std::printf("count: %s, %d of %d cards dealt, %s strategy, seed %llu\n", CardCounter::systemName(system),
+                cardsDealt, rules.decks * 52, strategyName, (unsigned long long) seed);
+    std::printf("  tc      weight       ev/round\n");
+    double weight = 0.0;
+    double weighted = 0.0;
+    double weightedVariance = 0.0;
+    for (int count = from; count <= to; ++count) {
+        if (!sampler.conditionOnTrueCount(count, count + 1)) {
+            continue;
+        }
+        RunningStats results = withRules(rules, [&](const auto& policy) {
+            if (std::strcmp(strategyName, "count") == 0) {
+                return playConditioned(policy, counting, sampler, system, rounds, rng);
+            }
+            return playConditioned(policy, basic, sampler, system, rounds, rng);
+        });
+        double chance = sampler.probability();
+        std::printf("%+4d %11.3e %+9.4f +/- %.4f\n", count, chance, results.mean(), results.confidenceHalfWidth());
+        weight += chance;
+        weighted += chance * results.mean();
+        weightedVariance += chance * chance * results.variance() / results.count();
+    }
+    if (weight > 0.0) {
+        std::printf("reweighted over %.4f%% of shoes: %+.5f +/- %.5f per round (95%%)\n", 100.0 * weight,
+                    weighted / weight, CONFIDENCE_95 * std::sqrt(weightedVariance) / weight);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("elapsed: %.3f s\n", seconds);
+    return 0;
+}
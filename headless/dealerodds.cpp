@@ -0,0 +1,62 @@
+#include "commands.h"
+#include "headers/composition.h"
+#include "headers/dealerprob.h"
+#include "headers/rules.h"
+
+#include <chrono>
+#include <cstdio>
+
+/**
+ * @file dealerodds.cpp
+ * @brief The dealer command: exact dealer outcome probabilities for a full shoe.
+ *
+ * Usage: bjsim dealer [rule options]. Prints, for each upcard, the chance of every final
+ * dealer total off the top of a freshly shuffled shoe, both before the dealer peeks and
+ * given that the dealer does not have blackjack.
+ */
+
+
+namespace {
+
+const char *UPCARD_NAMES[RANKS] = { "A", "2", "3", "4", "5", "6", "7", "8", "9", "T" };
+
+void printOutcome(const char *label, const DealerOutcome& outcome) {
+    std::printf("%-4s", label);
+    for (int i = 0; i < DEALER_RESULTS; ++i) {
+        std::printf(" %7.4f", outcome.probability[i]);
+    }
+    std::printf("\n");
+}
+
+} // namespace
+
+
+int runDealerOdds(int argc, char *argv[]) {
+    RuleSet rules;
+    for (int i = 1; i < argc; ++i) {
+        int consumed = parseRuleOption(rules, argc, argv, i);
+        if (consumed <= 0) {
+            printUsage();
+            return 2;
+        }
+        i += consumed - 1;
+    }
+
+    DealerProbabilities calculator(rules.hitSoft17);
+    auto start = std::chrono::steady_clock::now();
+
+    std::printf("rules: %s\n", rules.describe().c_str());
+    std::printf("up       17      18      19      20      21    bust      bj\n");
+    for (bool peeked : { false, true }) {
+        std::printf(peeked ? "given no dealer blackjack:\n" : "before the peek:\n");
+        for (int upcard = 0; upcard < RANKS; ++upcard) {
+            ShoeComposition shoe = ShoeComposition::fullShoe(rules.decks);
+            shoe.remove(upcard);
+            printOutcome(UPCARD_NAMES[upcard], calculator.outcome(shoe, upcard, peeked));
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("elapsed: %.3f ms, %zu memoized results\n", seconds * 1000.0, calculator.size());
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "commands.h"
+#include "headers/cache.h"
+#include "headers/counting.h"
+#include "headers/removal.h"
+#include "headers/rules.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * @file eor.cpp
+ * @brief The eor command: effects of removal and counting system scores.
+ *
+ * Usage: bjsim eor [--threads N] [--cache DIR | --no-cache] [--tags A,2,3,4,5,6,7,8,9,T]
+ * [rule options] [-- rule options ...]. Each group of rule options after the first "--"
+ * is another table to evaluate.
+ *
+ * Prints, for every table, the effect of removal of each rank in percent of the bet, worked
+ * out exactly (see removal.h), and the betting correlation, playing efficiency and insurance
+ * correlation of every built-in counting system and of the --tags system if one is given.
+ * Results are kept in a ResultCache under RuleSet::hash(), in BJ_CACHE_DIR or .bjsim-cache
+ * unless --cache says otherwise, so a table already computed is only read back; the tables
+ * that are not are computed together across all threads.
+ */
+
+
+namespace {
+
+const char *const RANK_NAMES[RANKS] = { "A", "2", "3", "4", "5", "6", "7", "8", "9", "T" };
+
+/// Reads ten comma-separated tags, ace first.
+bool parseTags(const char *text, int tags[RANKS]) {
+    for (int rank = 0; rank < RANKS; ++rank) {
+        char *end = nullptr;
+        tags[rank] = (int) std::strtol(text, &end, 10);
+        if (end == text || (rank < RANKS - 1 ? *end != ',' : *end != '\0')) {
+            return false;
+        }
+        text = end + 1;
+    }
+    return true;
+}
+
+
+void printEvaluation(const RemovalEffects& effects, const char *name, const int tags[RANKS]) {
+    CountEvaluation evaluation = evaluateCount(effects, tags);
+    std::printf("%-10s", name);
+    for (int rank = 0; rank < RANKS; ++rank) {
+        std::printf(" %+3d", tags[rank]);
+    }
+    std::printf("   %5.3f %5.3f %5.3f\n", evaluation.betting, evaluation.playing, evaluation.insurance);
+}
+
+} // namespace
+
+
+int runEffectsOfRemoval(int argc, char *argv[]) {
+    int threads = 0;
+    std::string cacheDirectory = ResultCache::defaultDirectory();
+    bool useCache = true;
+    int customTags[RANKS];
+    bool customGiven = false;
+    std::vector<RuleSet> tables(1);
+    for (int i = 1; i < argc; ++i) {
+        int consumed = parseRuleOption(tables.back(), argc, argv, i);
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (consumed > 0) {
+            i += consumed - 1;
+        } else if (consumed == 0 && std::strcmp(argv[i], "--") == 0) {
+            tables.emplace_back();
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--threads") == 0 && std::atoi(value) > 0) {
+            threads = std::atoi(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--cache") == 0) {
+            cacheDirectory = argv[++i];
+        } else if (consumed == 0 && std::strcmp(argv[i], "--no-cache") == 0) {
+            useCache = false;
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--tags") == 0 && parseTags(value, customTags)) {
+            customGiven = true;
+            ++i;
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ResultCache cache(cacheDirectory);
+    std::vector<RemovalEffects> effects(tables.size());
+    std::vector<bool> cached(tables.size(), false);
+    std::vector<RuleSet> missing;
+    for (std::size_t index = 0; index < tables.size(); ++index) {
+        std::string text;
+        effects[index].rules = tables[index];
+        cached[index] = useCache && cache.load("eor", tables[index].hash(), text) && effects[index].parse(text);
+        if (!cached[index]) {
+            missing.push_back(tables[index]);
+        }
+    }
+    std::vector<RemovalEffects> computed = computeRemovalEffects(missing, threads);
+    for (std::size_t index = 0, next = 0; index < tables.size(); ++index) {
+        if (cached[index]) {
+            continue;
+        }
+        effects[index] = computed[next++];
+        if (useCache && !cache.store("eor", tables[index].hash(), effects[index].serialize())) {
+            std::fprintf(stderr, "bjsim: could not write to the cache in %s\n", cache.directory().c_str());
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (std::size_t index = 0; index < tables.size(); ++index) {
+        const RemovalEffects& table = effects[index];
+        std::printf("rules: %s%s\n", table.rules.describe().c_str(), cached[index] ? " (cached)" : "");
+        std::printf("expected value per round: %+.4f%%\n", table.expectedValue * 100.0);
+        std::printf("effect of removal, %% per card per deck:\n");
+        for (int rank = 0; rank < RANKS; ++rank) {
+            std::printf("%8s", RANK_NAMES[rank]);
+        }
+        std::printf("\n");
+        for (int rank = 0; rank < RANKS; ++rank) {
+            std::printf(" %+7.4f", table.effect[rank] * 100.0);
+        }
+        std::printf("\nsystem       A  2  3  4  5  6  7  8  9  T      BC    PE    IC\n");
+        for (int system = 0; system < COUNT_SYSTEMS; ++system) {
+            int tags[RANKS];
+            for (int rank = 0; rank < RANKS; ++rank) {
+                tags[rank] = COUNTING_TAGS[system].tags[rank];
+            }
+            printEvaluation(table, COUNTING_TAGS[system].option, tags);
+        }
+        if (customGiven) {
+            printEvaluation(table, "--tags", customTags);
+        }
+        std::printf("\n");
+    }
+    std::printf("computed %zu of %zu tables, elapsed: %.3f s\n", missing.size(), tables.size(), seconds);
+    return 0;
+}
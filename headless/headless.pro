@@ -0,0 +1,23 @@
+# Console simulator built only on the core library; starts without any Qt initialisation.
+
+TEMPLATE = app
+TARGET = bjsim
+CONFIG += console
+CONFIG -= qt app_bundle
+
+include(../core/link.pri)
+
+SOURCES += \
+    analyze.cpp \
+    bankroll.cpp \
+    compare.cpp \
+    conditional.cpp \
+    dealerodds.cpp \
+    eor.cpp \
+    indices.cpp \
+    main.cpp \
+    simulate.cpp \
+    sweep.cpp
+
+HEADERS += \
+    commands.h
@@ -0,0 +1,534 @@
+#include "commands.h"
+#include "headers/DeckSetup.h"
+#include "headers/deviations.h"
+#include "headers/engine.h"
+#include "headers/rules.h"
+#include "headers/sampler.h"
+#include "headers/stats.h"
+#include "headers/strategy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file indices.cpp
+ * @brief The indices command: finds the true count at which each play deviation pays.
+ *
+ * Usage: bjsim indices [--trials N] [--depth F] [--count SYSTEM] [--threads N] [--seed S]
+ * [--out FILE] [rule options].
+ *
+ * For each candidate play (the well-known count-dependent plays and insurance), the
+ * difference in expected value between the deviation and basic strategy is measured in
+ * true count bins [T, T + 1). A measurement deals --trials shoes to the bin with
+ * ConditionalShoeSampler, a fraction F deep, takes out the hand and upcard, and plays the
+ * hand both ways on the same remaining cards. The sampler only conditions on the count, so
+ * each trial is weighted by the chance that its shoe deals that hand and upcard. Insurance
+ * is valued exactly from the cards left. Bins that no shoe reaches, or whose shoes never hold
+ * the hand, are left out. The lowest and highest bins that can be measured are measured
+ * first and then the bins between are bisected down to the pair where the difference changes
+ * sign; the index is where the line between those two crosses zero.
+ *
+ * All the candidates are searched at once, and the trials of every bin they need next are
+ * cut into chunks that are shared out between threads (see searchAll()). Each chunk draws
+ * from its own seed, so the table does not depend on the number of threads. With
+ * --out the indices are written as an IndexTable file, which simulate --indices and the
+ * GUI's moves chart load.
+ */
+
+
+namespace {
+
+constexpr int LOWEST_BIN = -10;
+constexpr int HIGHEST_BIN = 10;
+constexpr long CHUNK_TRIALS = 5000; /// Most trials in one unit of parallel work.
+
+/// A play that may change with the count: a starting hand, an upcard and the other action.
+struct Candidate {
+    const char *name;
+    int first;         /// Card values, with an ace as 1.
+    int second;
+    int upcard;
+    Action deviation;
+    bool insurance;    /// Insurance instead of a play; deviation is then unused.
+};
+
+const Candidate CANDIDATES[] = {
+    {"insurance", 10, 6, 1, ACTION_STAND, true},
+    {"16 v 10", 10, 6, 10, ACTION_STAND, false},
+    {"15 v 10", 10, 5, 10, ACTION_STAND, false},
+    {"10,10 v 5", 10, 10, 5, ACTION_SPLIT, false},
+    {"10,10 v 6", 10, 10, 6, ACTION_SPLIT, false},
+    {"10 v 10", 6, 4, 10, ACTION_DOUBLE, false},
+    {"12 v 3", 10, 2, 3, ACTION_STAND, false},
+    {"12 v 2", 10, 2, 2, ACTION_STAND, false},
+    {"11 v A", 6, 5, 1, ACTION_DOUBLE, false},
+    {"9 v 2", 5, 4, 2, ACTION_DOUBLE, false},
+    {"10 v A", 6, 4, 1, ACTION_DOUBLE, false},
+    {"9 v 7", 5, 4, 7, ACTION_DOUBLE, false},
+    {"16 v 9", 10, 6, 9, ACTION_STAND, false},
+    {"13 v 2", 10, 3, 2, ACTION_HIT, false},
+    {"12 v 4", 10, 2, 4, ACTION_HIT, false},
+    {"12 v 5", 10, 2, 5, ACTION_HIT, false},
+    {"12 v 6", 10, 2, 6, ACTION_HIT, false},
+    {"13 v 3", 10, 3, 3, ACTION_HIT, false},
+    {"14 v 10", 10, 4, 10, ACTION_SURRENDER, false},
+    {"15 v 9", 10, 5, 9, ACTION_SURRENDER, false},
+    {"15 v A", 10, 5, 1, ACTION_SURRENDER, false},
+};
+constexpr int CANDIDATE_COUNT = sizeof CANDIDATES / sizeof CANDIDATES[0];
+
+
+Card cardOf(int value) {
+    Card card;
+    card.name = value == 10 ? TEN : CardNames(value - 1);
+    card.suit = SPADES;
+    card.value = value;
+    return card;
+}
+
+
+/// What the search found for one candidate.
+struct IndexResult {
+    Action basic = ACTION_STAND;
+    bool skipped = false;       /// Basic strategy already plays the deviation.
+    bool unavailable = false;   /// The rules do not allow the deviation.
+    bool unmeasured = false;    /// No bin could be measured at this depth.
+    bool crosses = false;       /// The difference changes sign inside the bins searched.
+    bool atOrAbove = true;
+    double index = 0.0;
+    double lowDifference = 0.0; /// Differences in the two bins either side of the index,
+    double highDifference = 0.0; /// or at the ends of the search if it never crosses.
+    int lowBin = LOWEST_BIN;    /// The bins those differences are from.
+    int highBin = HIGHEST_BIN;
+    int bins = 0;               /// Bins measured.
+};
+
+
+/// Weighted sums over one chunk of a bin's trials.
+struct ChunkResult {
+    double weights = 0.0;
+    double weighted = 0.0;
+};
+
+
+/**
+ * @class CandidateSearch
+ * @brief Where the bisection of one candidate's bins has got to.
+ *
+ * wanted() names the bins whose differences the search needs next, and record() hands
+ * each one back, so the bins of every candidate can be measured together. A bin that cannot
+ * be measured is dropped from the search when it is recorded.
+ */
+class CandidateSearch {
+public:
+    IndexResult result;
+
+    CandidateSearch() {
+        for (int bin = LOWEST_BIN; bin <= HIGHEST_BIN; ++bin) {
+            bins.push_back(bin);
+        }
+    }
+
+    void finishEarly() { done = true; }
+
+    /// Bins to measure before the search can go on; empty once it is finished.
+    std::vector<int> wanted() {
+        while (!done) {
+            if (!bisecting) {
+                if (bins.empty()) {
+                    result.unmeasured = true;
+                    done = true;
+                    break;
+                }
+                // The lowest and highest bins that can be measured, found from the ends.
+                std::vector<int> needed;
+                for (int bin : {bins.front(), bins.back()}) {
+                    if (measured.count(bin) == 0 && (needed.empty() || needed[0] != bin)) {
+                        needed.push_back(bin);
+                    }
+                }
+                if (!needed.empty()) {
+                    return needed;
+                }
+                bisecting = true;
+                low = 0;
+                high = (int) bins.size() - 1;
+                result.crosses = (measured[bins[low]] > 0.0) != (measured[bins[high]] > 0.0);
+                continue;
+            }
+            if (!result.crosses || high - low <= 1) {
+                finish();
+                break;
+            }
+            int middle = (low + high) / 2;
+            auto found = measured.find(bins[middle]);
+            if (found == measured.end()) {
+                return {bins[middle]};
+            }
+            if ((found->second > 0.0) == (measured[bins[low]] > 0.0)) {
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+        return {};
+    }
+
+    /// The difference measured in a bin, or that it could not be measured.
+    void record(int bin, bool measurable, double difference) {
+        if (measurable) {
+            measured[bin] = difference;
+            return;
+        }
+        int position = (int) (std::find(bins.begin(), bins.end(), bin) - bins.begin());
+        bins.erase(bins.begin() + position);
+        if (bisecting && position <= high) {
+            --high;
+        }
+    }
+
+private:
+    void finish() {
+        result.lowBin = bins[low];
+        result.highBin = bins[high];
+        result.lowDifference = measured[result.lowBin];
+        result.highDifference = measured[result.highBin];
+        result.atOrAbove = result.highDifference > result.lowDifference;
+        result.bins = (int) measured.size();
+        if (result.crosses) {
+            // Each bin's result stands for the middle of the bin.
+            result.index = result.lowBin + 0.5 + (result.highBin - result.lowBin) * (0.0 - result.lowDifference)
+                / (result.highDifference - result.lowDifference);
+        }
+        done = true;
+    }
+
+    std::vector<int> bins;          /// Bins still in the search.
+    std::map<int, double> measured;
+    bool bisecting = false;
+    bool done = false;
+    int low = 0;                    /// Positions in bins of the pair being bisected.
+    int high = 0;
+};
+
+
+/**
+ * @class IndexWorker
+ * @brief One thread's sampler, shoe and engine for measuring chunks of trials.
+ */
+template <class Rules>
+class IndexWorker {
+public:
+    IndexWorker(const Rules& rules, CountingSystem system, int cardsDealt)
+        : rules(rules), system(system), sampler(rules.decks(), system, cardsDealt), shoe(rules.decks()),
+          engine(rules, shoe), strategy(rules.ruleSet()) {
+        engine.setCountingSystem(system);
+    }
+
+    Action basicAction(const Candidate& candidate) const {
+        Card hand[2] = {cardOf(candidate.first), cardOf(candidate.second)};
+        HandState state;
+        state.value = evaluateHand(hand, 2);
+        state.cardCount = 2;
+        state.dealerUpcard = upcardValue(cardOf(candidate.upcard));
+        state.pairValue = candidate.first == candidate.second ? upcardValue(hand[0]) : 0;
+        state.fromSplit = false;
+        state.canDouble = true;
+        state.canSplit = state.pairValue != 0 && rules.maxSplitHands() >= 2;
+        state.canSurrender = rules.surrender() != SURRENDER_NONE;
+        state.trueCount = 0.0;
+        return strategy.decide(state);
+    }
+
+    /**
+     * @brief Deviation less basic play, summed over trials in one true count bin.
+     *
+     * The sampler only conditions on the count, so each trial is weighted by the chance its
+     * shoe deals the hand and upcard; a bin no shoe reaches gives no weight at all.
+     */
+    ChunkResult measure(const Candidate& candidate, Action basic, int bin, long trials, std::mt19937& rng) {
+        ChunkResult chunk;
+        int tags = COUNTING_TAGS[system].tags[candidate.first - 1] + COUNTING_TAGS[system].tags[candidate.second - 1]
+            + COUNTING_TAGS[system].tags[candidate.upcard - 1];
+        if (!sampler.conditionOnTrueCount(bin, bin + 1, tags, 3)) {
+            return chunk;
+        }
+        cards[0] = cardOf(candidate.first);
+        cards[1] = cardOf(candidate.second);
+        upcard = cardOf(candidate.upcard);
+        for (long trial = 0; trial < trials; ++trial) {
+            sampler.deal(shoe, rng);
+            double weight = handChance(candidate);
+            if (weight <= 0.0) {
+                continue;
+            }
+            take(candidate.first);
+            take(candidate.second);
+            take(candidate.upcard);
+            std::shuffle(shoe.allDecks.begin() + shoe.nextCard, shoe.allDecks.end(), rng);
+            if (candidate.insurance) {
+                // Half a unit that pays 2:1 if the hole card is a ten, valued exactly.
+                int tens = 0;
+                for (int index = shoe.nextCard; index < shoe.size(); ++index) {
+                    tens += shoe.allDecks[index].value == 10;
+                }
+                double chance = double(tens) / shoe.remaining();
+                chunk.weights += weight;
+                chunk.weighted += weight * (chance - 0.5 * (1.0 - chance));
+                continue;
+            }
+            MultiDeck dealt = shoe;
+            double basicResult = engine.playDecision(strategy, cards, upcard, basic);
+            shoe = dealt;
+            double deviationResult = engine.playDecision(strategy, cards, upcard, candidate.deviation);
+            chunk.weights += weight;
+            chunk.weighted += weight * (deviationResult - basicResult);
+        }
+        return chunk;
+    }
+
+private:
+    /// Moves a card of the value to the front of the undealt cards and deals it.
+    bool take(int value) {
+        for (int index = shoe.nextCard; index < shoe.size(); ++index) {
+            if (shoe.allDecks[index].value == value) {
+                std::swap(shoe.allDecks[index], shoe.allDecks[shoe.nextCard]);
+                shoe.drawCard();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Chance that the undealt cards deal the candidate's two cards and then its upcard.
+    double handChance(const Candidate& candidate) const {
+        int left[11] = {};
+        for (int index = shoe.nextCard; index < shoe.size(); ++index) {
+            ++left[shoe.allDecks[index].value];
+        }
+        double chance = 1.0;
+        int remaining = shoe.remaining();
+        for (int value : {candidate.first, candidate.second, candidate.upcard}) {
+            if (left[value] <= 0) {
+                return 0.0;
+            }
+            chance *= double(left[value]--) / remaining--;
+        }
+        return chance;
+    }
+
+    Rules rules;
+    CountingSystem system;
+    ConditionalShoeSampler sampler;
+    MultiDeck shoe;
+    Engine<Rules> engine;
+    BasicStrategy strategy;
+    Card cards[2];
+    Card upcard;
+};
+
+
+/**
+ * @brief Searches every candidate, with the trials of every bin shared out between threads.
+ *
+ * The searches go forward together in steps. Each step gathers the bins every unfinished
+ * candidate needs next, cuts their trials into chunks of up to CHUNK_TRIALS and runs all
+ * the chunks on one pool of threads. Each chunk draws from its own seed, derived from S,
+ * the candidate, the bin and the chunk's number, and a bin's chunks are added up in order,
+ * so the table does not depend on the number of threads.
+ */
+template <class Rules>
+std::vector<IndexResult> searchAll(const Rules& rules, CountingSystem system, int cardsDealt, long trials,
+                                   int threads, std::uint64_t seed) {
+    std::vector<std::unique_ptr<IndexWorker<Rules>>> workers;
+    for (int index = 0; index < threads; ++index) {
+        workers.emplace_back(new IndexWorker<Rules>(rules, system, cardsDealt));
+    }
+    std::vector<CandidateSearch> searches(CANDIDATE_COUNT);
+    for (int index = 0; index < CANDIDATE_COUNT; ++index) {
+        const Candidate& candidate = CANDIDATES[index];
+        IndexResult& result = searches[index].result;
+        result.basic = workers[0]->basicAction(candidate);
+        result.unavailable = candidate.deviation == ACTION_SURRENDER && rules.surrender() == SURRENDER_NONE;
+        result.skipped = !result.unavailable && !candidate.insurance && result.basic == candidate.deviation;
+        if (result.unavailable || result.skipped) {
+            searches[index].finishEarly();
+        }
+    }
+
+    struct Chunk {
+        int request;
+        long first;  /// Index of the chunk's first trial in its bin.
+        long trials;
+    };
+    for (;;) {
+        std::vector<std::pair<int, int>> requests; // candidate and bin
+        for (int index = 0; index < CANDIDATE_COUNT; ++index) {
+            for (int bin : searches[index].wanted()) {
+                requests.emplace_back(index, bin);
+            }
+        }
+        if (requests.empty()) {
+            break;
+        }
+        std::vector<Chunk> chunks;
+        for (int request = 0; request < (int) requests.size(); ++request) {
+            for (long first = 0; first < trials; first += CHUNK_TRIALS) {
+                chunks.push_back(Chunk{request, first, std::min(CHUNK_TRIALS, trials - first)});
+            }
+        }
+
+        std::vector<ChunkResult> results(chunks.size());
+        std::atomic<std::size_t> next(0);
+        auto work = [&](IndexWorker<Rules>& worker) {
+            for (std::size_t index = next++; index < chunks.size(); index = next++) {
+                const Chunk& chunk = chunks[index];
+                int candidate = requests[chunk.request].first;
+                int bin = requests[chunk.request].second;
+                std::uint64_t stream = streamSeed(streamSeed(streamSeed(seed, candidate), bin - LOWEST_BIN),
+                                                  chunk.first / CHUNK_TRIALS);
+                std::seed_seq sequence{(unsigned) (stream & 0xffffffffU), (unsigned) (stream >> 32)};
+                std::mt19937 rng(sequence);
+                results[index] = worker.measure(CANDIDATES[candidate], searches[candidate].result.basic, bin,
+                                                chunk.trials, rng);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int index = 1; index < std::min<int>(threads, (int) chunks.size()); ++index) {
+            pool.emplace_back(work, std::ref(*workers[index]));
+        }
+        work(*workers[0]);
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+
+        // A request's chunks are consecutive, so each bin is added up in chunk order.
+        for (std::size_t index = 0; index < chunks.size();) {
+            int request = chunks[index].request;
+            ChunkResult sum;
+            for (; index < chunks.size() && chunks[index].request == request; ++index) {
+                sum.weights += results[index].weights;
+                sum.weighted += results[index].weighted;
+            }
+            searches[requests[request].first].record(requests[request].second, sum.weights > 0.0,
+                                                     sum.weights > 0.0 ? sum.weighted / sum.weights : 0.0);
+        }
+    }
+
+    std::vector<IndexResult> results;
+    for (const CandidateSearch& search : searches) {
+        results.push_back(search.result);
+    }
+    return results;
+}
+
+
+/// Strategy row a candidate's hand is looked up in.
+int candidateRow(const Candidate& candidate) {
+    if (candidate.first == candidate.second) {
+        return pairRow(candidate.first == 1 ? 11 : candidate.first);
+    }
+    Card cards[2] = {cardOf(candidate.first), cardOf(candidate.second)};
+    HandValue value = evaluateHand(cards, 2);
+    return value.soft ? softRow(value.total) : hardRow(value.total);
+}
+
+} // namespace
+
+
+int runIndices(int argc, char *argv[]) {
+    RuleSet rules;
+    double depth = 0.5;
+    long trials = 100000;
+    CountingSystem system = COUNT_HI_LO;
+    int threads = (int) std::max(1u, std::thread::hardware_concurrency());
+    std::uint64_t seed = std::random_device{}();
+    const char *out = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        int consumed = parseRuleOption(rules, argc, argv, i);
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (consumed > 0) {
+            i += consumed - 1;
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--depth") == 0 && std::atof(value) >= 0.0) {
+            depth = std::atof(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--trials") == 0 && std::atol(value) > 0) {
+            trials = std::atol(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--count") == 0 && parseCountingSystem(value, system)) {
+            ++i;
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--threads") == 0 && std::atoi(value) > 0) {
+            threads = std::atoi(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--seed") == 0) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--out") == 0) {
+            out = argv[++i];
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (depth >= rules.penetration) {
+        std::fprintf(stderr, "bjsim: --depth must be before the cut card (%.2f)\n", rules.penetration);
+        return 2;
+    }
+    int cardsDealt = (int) (depth * rules.decks * 52);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<IndexResult> results = withRules(rules, [&](const auto& policy) {
+        return searchAll(policy, system, cardsDealt, trials, threads, seed);
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("rules: %s\n", rules.describe().c_str());
+    std::printf("count: %s, %d of %d cards dealt, %ld trials per bin, seed %llu\n", CardCounter::systemName(system),
+                cardsDealt, rules.decks * 52, trials, (unsigned long long) seed);
+    std::printf("play         basic      deviation   index   bins\n");
+    IndexTable table;
+    table.system = system;
+    for (int index = 0; index < CANDIDATE_COUNT; ++index) {
+        const Candidate& candidate = CANDIDATES[index];
+        const IndexResult& result = results[index];
+        const char *deviation = candidate.insurance ? "insure" : actionName(candidate.deviation);
+        const char *basic = candidate.insurance ? "-" : actionName(result.basic);
+        if (result.unavailable || result.skipped || result.unmeasured) {
+            std::printf("%-12s %-10s %-10s  %s\n", candidate.name, basic, deviation,
+                        result.unavailable ? "not allowed" : result.skipped ? "basic already" : "no bin reachable");
+            continue;
+        }
+        if (!result.crosses) {
+            bool always = result.lowDifference > 0.0;
+            std::printf("%-12s %-10s %-10s  %s from %+d to %+d   %d\n", candidate.name, basic, deviation,
+                        always ? "always" : "never", result.lowBin, result.highBin, result.bins);
+            continue;
+        }
+        std::printf("%-12s %-10s %-10s  %s %+.1f   %d\n", candidate.name, basic, deviation,
+                    result.atOrAbove ? ">=" : "<=", result.index, result.bins);
+        if (candidate.insurance) {
+            table.insures = true;
+            table.insuranceIndex = result.index;
+        } else {
+            table.plays.push_back(Deviation{candidateRow(candidate), upcardValue(cardOf(candidate.upcard)),
+                                            candidate.deviation, result.index, result.atOrAbove});
+        }
+    }
+    std::printf("elapsed: %.3f s\n", seconds);
+
+    if (out) {
+        std::string comment = "bjsim indices for " + rules.describe();
+        if (!table.save(out, comment)) {
+            std::fprintf(stderr, "bjsim: could not write %s\n", out);
+            return 1;
+        }
+        std::printf("written to %s\n", out);
+    }
+    return 0;
+}
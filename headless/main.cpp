@@ -0,0 +1,76 @@
+#include "commands.h"
+#include "headers/metrics.h"
+#include "headers/trace.h"
+
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @file main.cpp
+ * @brief Entry point of the headless simulator.
+ *
+ * Usage: bjsim [command] [options]. The command defaults to simulate, so the original
+ * bjsim [--hands N] [rule options] form still works.
+ */
+
+
+void printUsage() {
+    std::fprintf(stderr,
+        "usage: bjsim [simulate] [--hands N] [--precision E] [--seats N] [--strategy basic|dealer|count]\n"
+        "       [--count hilo|ko|hiopt2|omega2|zen] [--ramp RAMP] [--threads N] [--seed S]\n"
+        "       [--antithetic] [--control] [--indices FILE] [--checkpoint FILE [--checkpoint-every SECONDS]]\n"
+        "       [rule options]\n"
+        "       bjsim compare [--shoes N] [--seed S] [--threads N] VARIANT [-- VARIANT ...]\n"
+        "       where VARIANT is [--strategy basic|dealer|count] [--count SYSTEM] [--ramp RAMP] [rule options]\n"
+        "       bjsim conditional [--depth F] [--from T] [--to T] [--rounds N] [--count SYSTEM]\n"
+        "       [--strategy basic|count] [--seed S] [rule options]\n"
+        "       bjsim dealer [rule options]\n"
+        "       bjsim eor [--threads N] [--cache DIR|--no-cache] [--tags A,2,3,4,5,6,7,8,9,T] [rule options]\n"
+        "       [-- rule options ...]\n"
+        "       bjsim sweep [--decks N,...] [--soft17 s17,h17] [--das yes,no] [--surrender none,late,early]\n"
+        "       [--payout N:D,...] [--penetration F,...] [--rounds N] [--threads N|--processes N] [--seed S]\n"
+        "       [--cache DIR|--no-cache] [rule options]\n"
+        "       bjsim indices [--trials N] [--depth F] [--count SYSTEM] [--threads N] [--seed S] [--out FILE]\n"
+        "       [rule options]\n"
+        "       bjsim analyze [--threads N] [rule options]\n"
+        "       bjsim bankroll [--paths N] [--rounds N] [--bankroll U] [--stop-win U] [--stop-loss U]\n"
+        "       [--checkpoints N] [--ramp RAMP] [--count SYSTEM] [--threads N] [--seed S] [rule options]\n"
+        "ramps: fixed:MIN:MAX[:STEP[:PIVOT]] | kelly:BANKROLL[:FRACTION[:MIN[:MAX]]] | table:TC=BET,...\n"
+        "rule options: [--decks N] [--h17|--s17] [--das|--no-das] [--payout N:D] [--max-splits N]\n"
+        "       [--rsa] [--hsa] [--surrender none|late|early] [--peek|--enhc] [--penetration F]\n");
+}
+
+
+int main(int argc, char *argv[]) {
+    tracing::startFromEnvironment();
+    metrics::startFromEnvironment();
+
+    if (argc > 1 && std::strcmp(argv[1], "dealer") == 0) {
+        return runDealerOdds(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "bankroll") == 0) {
+        return runBankroll(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "compare") == 0) {
+        return runCompare(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "conditional") == 0) {
+        return runConditional(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "eor") == 0) {
+        return runEffectsOfRemoval(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "sweep") == 0) {
+        return runSweep(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "indices") == 0) {
+        return runIndices(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "analyze") == 0) {
+        return runAnalyze(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "simulate") == 0) {
+        return runSimulate(argc - 1, argv + 1);
+    }
+    return runSimulate(argc, argv);
+}
@@ -0,0 +1,517 @@
+#include "commands.h"
+#include "headers/DeckSetup.h"
+#include "headers/analyzer.h"
+#include "headers/betting.h"
+#include "headers/checkpoint.h"
+#include "headers/engine.h"
+#include "headers/rules.h"
+#include "headers/stats.h"
+#include "headers/strategy.h"
+#include "headers/metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file simulate.cpp
+ * @brief The simulate command: plays rounds and reports the result.
+ *
+ * Plays rounds against the dealer using only the core library and prints the results.
+ * Usage: bjsim [simulate] [--hands N] [--precision E] [--seats N]
+ * [--strategy basic|dealer|count] [--count SYSTEM] [--ramp RAMP] [--threads N] [--seed S]
+ * [--antithetic] [--control] [--indices FILE] [--checkpoint FILE [--checkpoint-every SECONDS]]
+ * [rule options]; see parseRuleOption() for the rule options and parseBetRamp() for ramps.
+ * --hands counts rounds; every seat plays one hand per round. Seats play basic strategy
+ * unless told to mimic the dealer, or to count, which also insures at a true count of +3 or
+ * more in the system chosen by --count (Hi-Lo by default). --indices FILE plays by an
+ * IndexTable, such as one written by bjsim indices, counting in the table's system. Every
+ * seat bets what the ramp gives for the true count before the round, one unit flat by
+ * default; with a ramp or counting, results are also reported per true count.
+ *
+ * Results are kept as streaming statistics (see stats.h), per hand and per seat's opening
+ * decision, so the report carries a 95% confidence interval and the higher moments. With
+ * --precision E the run stops as soon as that interval on net units per hand is no wider
+ * than plus or minus E; --hands is then only a limit, and there is none unless it is given.
+ * With --seed each thread's shoe is seeded from S and the thread's index, so a run with the
+ * same options and no precision target deals the same cards again.
+ *
+ * With --checkpoint FILE (which needs --seed and no --precision), every thread saves its
+ * shoe, generator, results and progress to FILE every SECONDS (60 by default) and when it
+ * finishes. Running the same command again after the run was killed resumes each thread
+ * from its saved state, and the final results are bit for bit those of an uninterrupted
+ * run. The file is deleted once the run completes; see checkpoint.h.
+ *
+ * Two optional estimators reduce the variance of the result. --antithetic deals every
+ * shuffled shoe a second time in reverse and averages each pair of shoes. --control uses
+ * the exact value of each seat's starting hand against the upcard (from analyzeShoe() on a
+ * full shoe) as a control variate. That value's mean is the analyzer's expected value,
+ * since the first cards of every round have the full shoe's distribution. The cut card
+ * biases that slightly (the cut-card effect), so the adjusted figure is best read at the
+ * precision the analyzer itself is trusted to. Both report their effective-sample-size
+ * gain: how many more rounds plain simulation would need for the same interval.
+ */
+
+
+namespace {
+
+constexpr long METRICS_BATCH = 4096;           /// Rounds between reports from each thread.
+constexpr long MIN_PRECISION_ROUNDS = 100000;  /// Fewest rounds a precision target may stop at.
+
+const char *const OPENING_NAMES[ACTION_KINDS + 1] = {"none", "stand", "hit", "double", "split", "surrender"};
+
+/// Totals collected over a run.
+struct RunResult {
+    long rounds = 0;
+    long hands = 0;    /// Seat-rounds: rounds times seats.
+    double net = 0.0;
+    RunningStats perHand;                        /// Each round's net divided by the seats.
+    RunningStats openings[ACTION_KINDS + 1];     /// Seat result per initial bet, by openingAction() + 1.
+    RunningStats shoes;                          /// Net per round of each shoe, with --antithetic.
+    RunningStats pairs;                          /// Mean of each antithetic pair of shoes.
+    RunningCovariance control;                   /// Exact starting value and result, per round.
+    BettingStats betting;
+
+    void merge(const RunResult& other) {
+        rounds += other.rounds;
+        hands += other.hands;
+        net += other.net;
+        perHand.merge(other.perHand);
+        shoes.merge(other.shoes);
+        pairs.merge(other.pairs);
+        control.merge(other.control);
+        for (int action = 0; action <= ACTION_KINDS; ++action) {
+            openings[action].merge(other.openings[action]);
+        }
+        betting.merge(other.betting);
+    }
+};
+
+
+/// Which variance reduction estimators a run keeps.
+struct Estimators {
+    bool antithetic = false;
+    const AnalysisReport *exact = nullptr; /// Starting hand values for the control variate.
+};
+
+
+static_assert(std::is_trivially_copyable<RunResult>::value, "RunResult is saved in checkpoints as it is");
+
+
+/// Collects per-shoe results and pairs them up for the antithetic estimator.
+struct ShoePairing {
+    double net = 0.0;
+    long rounds = 0;
+    double pending = 0.0; /// First shoe of an unfinished pair.
+    bool paired = false;
+
+    void closeShoe(RunResult& result) {
+        double mean = net / rounds;
+        result.shoes.add(mean);
+        if (paired) {
+            result.pairs.add(0.5 * (pending + mean));
+        }
+        pending = mean;
+        paired = !paired;
+        net = 0.0;
+        rounds = 0;
+    }
+};
+
+
+/// Exact value of a seat's starting hand and the upcard, from a full-shoe analysis.
+template <class Rules>
+double startingValue(const Engine<Rules>& engine, int seat, const AnalysisReport& exact) {
+    int first = rankIndex(engine.dealtCards(seat)[0]);
+    int second = rankIndex(engine.dealtCards(seat)[1]);
+    if (first > second) {
+        std::swap(first, second);
+    }
+    return exact.initialValue[rankIndex(engine.dealerUpcard())][first][second];
+}
+
+
+/**
+ * @class PrecisionTarget
+ * @brief Where simulation threads pool their per-hand results to decide when to stop.
+ */
+class PrecisionTarget {
+public:
+    /// @param halfWidth Target 95% half-width of net units per hand; 0 never stops early.
+    explicit PrecisionTarget(double halfWidth) : halfWidth(halfWidth) {}
+
+    bool reached() const { return done.load(std::memory_order_relaxed); }
+
+    /// Adds a thread's latest results and returns true once the target is reached.
+    bool report(const RunningStats& batch) {
+        if (halfWidth <= 0.0) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        pooled.merge(batch);
+        if (pooled.count() >= (std::uint64_t) MIN_PRECISION_ROUNDS && pooled.confidenceHalfWidth() <= halfWidth) {
+            done.store(true, std::memory_order_relaxed);
+        }
+        return reached();
+    }
+
+private:
+    double halfWidth;
+    std::mutex mutex;
+    RunningStats pooled;
+    std::atomic<bool> done{false};
+};
+
+/// A thread's progress, results so far and shoe, as saved in a checkpoint between batches.
+std::string saveStream(long round, const RunResult& result, const ShoePairing& pairing, const MultiDeck& shoe) {
+    SnapshotWriter snapshot;
+    snapshot.put(round);
+    snapshot.put(result);
+    snapshot.put(pairing);
+    shoe.save(snapshot);
+    return snapshot.data();
+}
+
+bool restoreStream(const std::string& state, long& round, RunResult& result, ShoePairing& pairing, MultiDeck& shoe) {
+    SnapshotReader snapshot(state);
+    return snapshot.get(round) && snapshot.get(result) && snapshot.get(pairing) && shoe.restore(snapshot)
+        && snapshot.atEnd();
+}
+
+
+/// Plays rounds on one shoe, betting off the ramp, and collects the results locally. With a
+/// checkpoint, the thread's state is saved there every so often between batches and once
+/// more at the end, and a state saved by an earlier attempt is carried on from.
+template <class Rules, class Strategy>
+RunResult simulateShoe(const Rules& rules, const Strategy& strategy, const BetRamp& ramp, long rounds, int seats,
+                       CountingSystem system, PrecisionTarget& target, const std::uint64_t *seed,
+                       const Estimators& estimators, CheckpointFile *checkpoint, int stream) {
+    MultiDeck shoe(rules.decks());
+    RunResult result;
+    RunningStats batch;
+    ShoePairing pairing;
+    long round = 0;
+    const std::string *saved = checkpoint ? checkpoint->state(stream) : nullptr;
+    if (!saved || !restoreStream(*saved, round, result, pairing, shoe)) {
+        round = 0;
+        result = RunResult();
+        pairing = ShoePairing();
+        shoe = MultiDeck(rules.decks());
+        if (seed) {
+            shoe.seed(*seed);
+        }
+        shoe.antithetic = estimators.antithetic;
+        shoe.createAndShuffleDecks();
+    }
+    Engine<Rules> engine(rules, shoe, seats);
+    engine.setCountingSystem(system);
+
+    while (round < rounds && !target.reached()) {
+        if (estimators.antithetic && pairing.rounds > 0 && shoe.needsShuffle(rules.penetration())) {
+            pairing.closeShoe(result);
+        }
+        double trueCount = engine.trueCount();
+        double bet = ramp.bet(trueCount);
+        double net = engine.playRound(strategy, bet);
+        result.net += net;
+        result.betting.add(trueCount, bet * engine.seatCount(), net);
+        batch.add(net / engine.seatCount());
+        pairing.net += net / engine.seatCount();
+        ++pairing.rounds;
+        double exactValue = 0.0;
+        for (int seat = 0; seat < engine.seatCount(); ++seat) {
+            result.openings[engine.openingAction(seat) + 1].add(engine.seatResult(seat) / bet);
+            if (estimators.exact) {
+                exactValue += bet * startingValue(engine, seat, *estimators.exact);
+            }
+        }
+        if (estimators.exact) {
+            result.control.add(exactValue / engine.seatCount(), net / engine.seatCount());
+        }
+        if (++round % METRICS_BATCH == 0) {
+            metrics::handsPlayed.add(METRICS_BATCH * engine.seatCount());
+            target.report(batch);
+            result.perHand.merge(batch);
+            batch = RunningStats();
+            if (checkpoint && checkpoint->due(stream)) {
+                checkpoint->save(stream, saveStream(round, result, pairing, shoe));
+            }
+        }
+    }
+    metrics::handsPlayed.add(round % METRICS_BATCH * engine.seatCount());
+    result.perHand.merge(batch);
+    result.rounds = round;
+    result.hands = round * engine.seatCount();
+    if (checkpoint) {
+        checkpoint->save(stream, saveStream(round, result, pairing, shoe));
+    }
+    return result;
+}
+
+/// Plays the requested number of rounds on an engine specialised for the rules, split over
+/// threads that each deal their own shoe and merge their results at the end. With a
+/// precision target the threads all stop once their pooled results reach it. A seed, if
+/// given, seeds thread i's shoe with streamSeed(seed, i); a checkpoint keeps one stream per
+/// thread.
+template <class Rules, class Strategy>
+RunResult simulate(const Rules& rules, const Strategy& strategy, const BetRamp& ramp, long rounds, int seats,
+                   CountingSystem system, int threads, double precision, const std::uint64_t *seed,
+                   const Estimators& estimators, CheckpointFile *checkpoint) {
+    PrecisionTarget target(precision);
+    std::vector<RunResult> partial(threads);
+    std::vector<std::thread> workers;
+    for (int index = 0; index < threads; ++index) {
+        long share = rounds / threads + (index < rounds % threads ? 1 : 0);
+        workers.emplace_back([&, index, share] {
+            std::uint64_t stream = seed ? streamSeed(*seed, index) : 0;
+            partial[index] = simulateShoe(rules, strategy, ramp, share, seats, system, target,
+                                          seed ? &stream : nullptr, estimators, checkpoint, index);
+        });
+    }
+
+    RunResult result;
+    for (int index = 0; index < threads; ++index) {
+        workers[index].join();
+        result.merge(partial[index]);
+    }
+    return result;
+}
+
+/// FNV-1a hash of a description of everything a run's results depend on.
+std::uint64_t runFingerprint(const std::string& description) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char character : description) {
+        hash = (hash ^ character) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+
+/// Prints results per count bin and for the whole ramp.
+void printBetting(const BettingStats& betting) {
+    std::printf("  tc    freq   avg bet  ev/unit  sd/unit      SCORE          N0\n");
+    for (int bin = 0; bin < COUNT_BINS; ++bin) {
+        const BinStats& stats = betting.bins[bin];
+        if (stats.rounds == 0) {
+            continue;
+        }
+        const char *edge = bin == 0 ? "<=" : (bin == COUNT_BINS - 1 ? ">=" : "  ");
+        std::printf("%s%+3d %6.2f%% %9.2f %+7.3f%% %8.3f %10.2f %11.0f\n", edge, binCount(bin),
+                    100.0 * stats.rounds / betting.total().rounds, stats.wagered / stats.rounds,
+                    100.0 * stats.unitExpectation(), stats.unitDeviation(), stats.score(), stats.n0());
+    }
+
+    BinStats total = betting.total();
+    std::printf("win rate: %+.4f units per 100 rounds, sd %.3f per 100 rounds\n", 100.0 * total.winRate(),
+                10.0 * total.standardDeviation());
+    std::printf("SCORE: %.2f  N0: %.0f rounds\n", total.score(), total.n0());
+}
+
+/// Prints the variance reduction estimators that were kept.
+void printEstimators(const RunResult& result, const Estimators& estimators) {
+    if (estimators.antithetic && result.pairs.count() > 1) {
+        const RunningStats& pairs = result.pairs;
+        std::printf("antithetic: %llu shoe pairs, net per round %+.5f +/- %.5f (95%%), ESS gain %.2fx\n",
+                    (unsigned long long) pairs.count(), pairs.mean(), pairs.confidenceHalfWidth(),
+                    pairs.variance() > 0.0 ? 0.5 * result.shoes.variance() / pairs.variance() : 0.0);
+    }
+    if (estimators.exact && result.control.count() > 1) {
+        const RunningCovariance& control = result.control;
+        double expected = estimators.exact->expectedValue;
+        double correlation = control.correlation();
+        double remaining = 1.0 - correlation * correlation;
+        double adjusted = control.meanY() - control.slope() * (control.meanX() - expected);
+        double halfWidth = CONFIDENCE_95 * std::sqrt(control.varianceY() * remaining / control.count());
+        std::printf("control variate: exact starting value %+.5f, correlation %.3f\n", expected, correlation);
+        std::printf("  net units per hand %+.5f +/- %.5f (95%%), ESS gain %.2fx\n", adjusted, halfWidth,
+                    remaining > 0.0 ? 1.0 / remaining : 0.0);
+    }
+}
+
+
+/// Prints each seat's results by the first action it took.
+void printOpenings(const RunResult& result) {
+    std::printf("opening      freq   ev/bet   sd/bet    skew    kurt\n");
+    for (int action = 0; action <= ACTION_KINDS; ++action) {
+        const RunningStats& stats = result.openings[action];
+        if (stats.count() == 0) {
+            continue;
+        }
+        std::printf("%-9s %6.2f%% %+8.4f %8.4f %7.3f %7.3f\n", OPENING_NAMES[action],
+                    100.0 * stats.count() / result.hands, stats.mean(), stats.standardDeviation(),
+                    stats.skewness(), stats.excessKurtosis());
+    }
+}
+
+} // namespace
+
+
+int runSimulate(int argc, char *argv[]) {
+    long hands = 100000;
+    bool handsGiven = false;
+    double precision = 0.0;
+    int seats = 1;
+    const char *strategyName = "basic";
+    CountingSystem system = COUNT_HI_LO;
+    BetRamp ramp;
+    bool rampGiven = false;
+    int threads = 1;
+    std::uint64_t seed = 0;
+    bool seedGiven = false;
+    Estimators estimators;
+    bool control = false;
+    IndexTable indices;
+    const char *checkpointPath = nullptr;
+    double checkpointSeconds = 60.0;
+    RuleSet rules;
+    for (int i = 1; i < argc; ++i) {
+        int consumed = parseRuleOption(rules, argc, argv, i);
+        if (consumed > 0) {
+            i += consumed - 1;
+        } else if (consumed == 0 && std::strcmp(argv[i], "--hands") == 0 && i + 1 < argc) {
+            hands = std::atol(argv[++i]);
+            handsGiven = true;
+        } else if (consumed == 0 && std::strcmp(argv[i], "--precision") == 0 && i + 1 < argc
+                   && std::atof(argv[i + 1]) > 0) {
+            precision = std::atof(argv[++i]);
+        } else if (consumed == 0 && std::strcmp(argv[i], "--seats") == 0 && i + 1 < argc) {
+            seats = std::atoi(argv[++i]);
+            if (seats < 1 || seats > MAX_SEATS) {
+                std::fprintf(stderr, "bjsim: --seats must be between 1 and %d\n", MAX_SEATS);
+                return 2;
+            }
+        } else if (consumed == 0 && std::strcmp(argv[i], "--strategy") == 0 && i + 1 < argc
+                   && (std::strcmp(argv[i + 1], "basic") == 0 || std::strcmp(argv[i + 1], "dealer") == 0
+                       || std::strcmp(argv[i + 1], "count") == 0)) {
+            strategyName = argv[++i];
+        } else if (consumed == 0 && std::strcmp(argv[i], "--count") == 0 && i + 1 < argc
+                   && parseCountingSystem(argv[i + 1], system)) {
+            ++i;
+        } else if (consumed == 0 && std::strcmp(argv[i], "--ramp") == 0 && i + 1 < argc
+                   && parseBetRamp(argv[i + 1], ramp)) {
+            rampGiven = true;
+            ++i;
+        } else if (consumed == 0 && std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc
+                   && std::atoi(argv[i + 1]) > 0) {
+            threads = std::atoi(argv[++i]);
+        } else if (consumed == 0 && std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+            seedGiven = true;
+        } else if (consumed == 0 && std::strcmp(argv[i], "--antithetic") == 0) {
+            estimators.antithetic = true;
+        } else if (consumed == 0 && std::strcmp(argv[i], "--control") == 0) {
+            control = true;
+        } else if (consumed == 0 && std::strcmp(argv[i], "--indices") == 0 && i + 1 < argc) {
+            if (!indices.load(argv[++i])) {
+                std::fprintf(stderr, "bjsim: could not read index table %s\n", argv[i]);
+                return 2;
+            }
+            strategyName = "index";
+            system = indices.system;
+        } else if (consumed == 0 && std::strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            checkpointPath = argv[++i];
+        } else if (consumed == 0 && std::strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc
+                   && std::atof(argv[i + 1]) > 0) {
+            checkpointSeconds = std::atof(argv[++i]);
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (precision > 0.0 && !handsGiven) {
+        hands = std::numeric_limits<long>::max();
+    }
+
+    if (control && rampGiven) {
+        std::fprintf(stderr, "bjsim: --control needs flat one-unit bets\n");
+        return 2;
+    }
+    if (!ramp.setCountingSystem(system)) {
+        std::fprintf(stderr, "bjsim: a kelly ramp needs a balanced count, not %s\n", CardCounter::systemName(system));
+        return 2;
+    }
+
+    std::unique_ptr<CheckpointFile> checkpoint;
+    if (checkpointPath) {
+        if (!seedGiven || precision > 0.0) {
+            std::fprintf(stderr, "bjsim: --checkpoint needs --seed and no --precision, "
+                                 "so a resumed run plays the same rounds\n");
+            return 2;
+        }
+        char options[256];
+        std::snprintf(options, sizeof options, "%llx %ld %d %s %d %d %llu %d %d ", (unsigned long long) rules.hash(),
+                      hands, seats, strategyName, (int) system, threads, (unsigned long long) seed,
+                      (int) estimators.antithetic, (int) control);
+        std::string description = options + ramp.describe() + "\n" + indices.format();
+        checkpoint.reset(new CheckpointFile(checkpointPath, runFingerprint(description), threads,
+                                            std::chrono::milliseconds((long long) (checkpointSeconds * 1000.0))));
+        if (checkpoint->load()) {
+            std::fprintf(stderr, "bjsim: resuming from %s\n", checkpointPath);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<AnalysisReport> exact;
+    if (control) {
+        exact.reset(new AnalysisReport(analyzeShoe(rules, ShoeComposition::fullShoe(rules.decks), threads)));
+        estimators.exact = exact.get();
+    }
+    BasicStrategy basic(rules);
+    CountingStrategy counting(rules);
+    MimicDealerStrategy mimic;
+    IndexStrategy indexed(rules, indices);
+    const std::uint64_t *baseSeed = seedGiven ? &seed : nullptr;
+    RunResult result = withRules(rules, [&](const auto& policy) {
+        if (std::strcmp(strategyName, "dealer") == 0) {
+            return simulate(policy, mimic, ramp, hands, seats, system, threads, precision, baseSeed, estimators,
+                            checkpoint.get());
+        } else if (std::strcmp(strategyName, "count") == 0) {
+            return simulate(policy, counting, ramp, hands, seats, system, threads, precision, baseSeed, estimators,
+                            checkpoint.get());
+        } else if (std::strcmp(strategyName, "index") == 0) {
+            return simulate(policy, indexed, ramp, hands, seats, system, threads, precision, baseSeed, estimators,
+                            checkpoint.get());
+        }
+        return simulate(policy, basic, ramp, hands, seats, system, threads, precision, baseSeed, estimators,
+                        checkpoint.get());
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (checkpoint) {
+        checkpoint->remove();
+    }
+
+    std::printf("rules: %s\n", rules.describe().c_str());
+    std::printf("strategy: %s\n", strategyName);
+    bool reportCounts = rampGiven || std::strcmp(strategyName, "count") == 0
+        || std::strcmp(strategyName, "index") == 0;
+    if (reportCounts) {
+        std::printf("count: %s\n", CardCounter::systemName(system));
+        std::printf("ramp: %s\n", ramp.describe().c_str());
+    }
+    std::printf("seats: %d\n", seats);
+    std::printf("rounds: %ld\n", result.rounds);
+    std::printf("hands: %ld\n", result.hands);
+    std::printf("net units per hand: %+.5f +/- %.5f (95%%)\n", result.perHand.mean(),
+                result.perHand.confidenceHalfWidth());
+    std::printf("sd per hand: %.4f  skewness: %.3f  excess kurtosis: %.3f\n", result.perHand.standardDeviation(),
+                result.perHand.skewness(), result.perHand.excessKurtosis());
+    std::printf("elapsed: %.3f s (%.0f hands/s)\n", seconds, seconds > 0 ? result.hands / seconds : 0.0);
+    printEstimators(result, estimators);
+    printOpenings(result);
+    if (reportCounts) {
+        printBetting(result.betting);
+    }
+    return 0;
+}
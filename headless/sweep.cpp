@@ -0,0 +1,361 @@
+#include "commands.h"
+#include "headers/DeckSetup.h"
+#include "headers/cache.h"
+#include "headers/checkpoint.h"
+#include "headers/engine.h"
+#include "headers/processpool.h"
+#include "headers/rules.h"
+#include "headers/stats.h"
+#include "headers/strategy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file sweep.cpp
+ * @brief The sweep command: the house edge over a grid of rule variations.
+ *
+ * Usage: bjsim sweep [--decks N,...] [--soft17 s17,h17] [--das yes,no]
+ * [--surrender none,late,early] [--payout N:D,...] [--penetration F,...] [--rounds N]
+ * [--threads N | --processes N] [--seed S] [--cache DIR | --no-cache] [rule options].
+ *
+ * Each list is one axis of the grid and every combination is a cell; rules not swept come
+ * from the rule options. A cell plays --rounds rounds of basic strategy, one unit flat, in
+ * shards of up to SHARD_ROUNDS rounds. Each shard deals its own shoe, seeded from --seed
+ * (0 by default), the cell's RuleSet::hash() and the shard's number, and a cell's shards
+ * are combined in order. So a cell gives the same result whenever and wherever it is
+ * computed, whether on threads or processes.
+ *
+ * Cells already in the ResultCache with at least as many rounds from the same seed and
+ * CELL_FORMAT are read back, and reported with the rounds they were stored with. The shards
+ * of the rest go into a priority queue, largest estimated cost first, so the last shards to
+ * finish are short ones. A pool of threads works through it, or with --processes a pool of
+ * forked worker processes (see processpool.h). A worker process that crashes loses only its
+ * current shard, which is retried once in a new worker; a cell with a shard that fails twice
+ * is reported incomplete and not cached. Every finished cell is stored as soon as it is
+ * done, so an interrupted or extended sweep only computes the cells it does not have.
+ */
+
+
+namespace {
+
+/// One swept rule: the rule options for each of its values.
+struct Axis {
+    std::vector<std::vector<std::string>> values;
+};
+
+constexpr long SHARD_ROUNDS = 250000; /// Most rounds in one unit of work.
+constexpr int SHARD_ATTEMPTS = 2;      /// Times a shard is tried in a fresh worker process.
+
+/// Version of stored cells. Raise it whenever a change to the engine or the sharding alters
+/// what a cell plays, so results from before it are computed again rather than read back.
+constexpr int CELL_FORMAT = 3;
+
+/// One combination of rules and what is known about it.
+struct Cell {
+    RuleSet rules;
+    bool cached = false;
+    long rounds = 0;                 /// Rounds played, more than asked for if read back.
+    RunningStats results;            /// Net units per round.
+    std::vector<RunningStats> parts; /// Results of each shard, combined in order.
+    int remaining = 0;               /// Shards not yet finished.
+    int lost = 0;                    /// Shards whose worker process kept failing.
+};
+
+/// A run of rounds for one cell, from a seed of its own.
+struct Shard {
+    int cell;
+    int part;
+    long rounds;
+    double cost; /// Estimated work, for scheduling.
+};
+
+
+/// Splits a comma-separated list into one set of rule options per item.
+bool parseAxis(const char *option, const char *list, Axis& axis) {
+    axis.values.clear();
+    std::string text(list);
+    std::size_t start = 0;
+    while (start <= text.size()) {
+        std::size_t end = text.find(',', start);
+        end = end == std::string::npos ? text.size() : end;
+        std::string item = text.substr(start, end - start);
+        if (std::strcmp(option, "--soft17") == 0 && (item == "s17" || item == "h17")) {
+            axis.values.push_back({"--" + item});
+        } else if (std::strcmp(option, "--das") == 0 && (item == "yes" || item == "no")) {
+            axis.values.push_back({item == "yes" ? "--das" : "--no-das"});
+        } else if (std::strcmp(option, "--soft17") != 0 && std::strcmp(option, "--das") != 0 && !item.empty()) {
+            axis.values.push_back({option, item});
+        } else {
+            return false;
+        }
+        start = end + 1;
+    }
+    return !axis.values.empty();
+}
+
+
+/// Applies rule options to a rule set; returns false if any is invalid.
+bool applyOptions(RuleSet& rules, const std::vector<std::string>& options) {
+    std::vector<char *> argv;
+    for (const std::string& option : options) {
+        argv.push_back(const_cast<char *>(option.c_str()));
+    }
+    return parseRuleOption(rules, (int) argv.size(), argv.data(), 0) == (int) argv.size();
+}
+
+
+/// Rough relative cost of rounds of a cell: tables without a fixed-rules engine run slower, and a
+/// shallow cut card shuffles more often.
+double estimateCost(const RuleSet& rules, long rounds) {
+    bool specialised = withRules(rules, [](const auto& policy) {
+        return !std::is_same<std::decay_t<decltype(policy)>, DynamicRules>::value;
+    });
+    return rounds * (specialised ? 1.0 : 1.5) * (1.0 + 0.2 / rules.penetration);
+}
+
+
+template <class Rules>
+RunningStats playCell(const Rules& rules, long rounds, std::uint64_t seed) {
+    MultiDeck shoe(rules.decks());
+    shoe.seed(seed);
+    shoe.createAndShuffleDecks();
+    Engine<Rules> engine(rules, shoe);
+    BasicStrategy strategy(rules.ruleSet());
+    RunningStats results;
+    for (long round = 0; round < rounds; ++round) {
+        results.add(engine.playRound(strategy));
+    }
+    return results;
+}
+
+
+std::string formatCell(const RunningStats& results, long rounds, std::uint64_t seed) {
+    RunningStats::State state = results.state();
+    char text[512];
+    std::snprintf(text, sizeof text,
+                  "format %d\nrounds %ld\nseed %" PRIu64 "\nmoments %" PRIu64 " %.17g %.17g %.17g %.17g\n",
+                  CELL_FORMAT, rounds, seed, state.n, state.mean, state.m2, state.m3, state.m4);
+    return text;
+}
+
+
+/// Reads a stored cell; returns false unless it is in the current format, from the seed and
+/// with enough rounds.
+bool parseCell(const std::string& text, long rounds, std::uint64_t seed, Cell& cell) {
+    int format = 0;
+    long storedRounds = 0;
+    std::uint64_t storedSeed = 0;
+    RunningStats::State state;
+    if (std::sscanf(text.c_str(), "format %d\nrounds %ld\nseed %" SCNu64 "\nmoments %" SCNu64 " %lg %lg %lg %lg",
+                    &format, &storedRounds, &storedSeed, &state.n, &state.mean, &state.m2, &state.m3, &state.m4) != 8
+        || format != CELL_FORMAT || storedSeed != seed || storedRounds < rounds) {
+        return false;
+    }
+    cell.rounds = storedRounds;
+    cell.results = RunningStats::fromState(state);
+    return true;
+}
+
+} // namespace
+
+
+int runSweep(int argc, char *argv[]) {
+    RuleSet base;
+    std::vector<Axis> axes;
+    long rounds = 1000000;
+    int threads = (int) std::max(1u, std::thread::hardware_concurrency());
+    int processes = 0;
+    std::uint64_t seed = 0;
+    std::string cacheDirectory = ResultCache::defaultDirectory();
+    bool useCache = true;
+    const char *const AXES[] = {"--decks", "--soft17", "--das", "--surrender", "--payout", "--penetration"};
+    for (int i = 1; i < argc; ++i) {
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool axis = false;
+        for (const char *name : AXES) {
+            axis = axis || std::strcmp(argv[i], name) == 0;
+        }
+        if (axis && value) {
+            axes.emplace_back();
+            if (!parseAxis(argv[i], value, axes.back())) {
+                printUsage();
+                return 2;
+            }
+            ++i;
+            continue;
+        }
+        int consumed = parseRuleOption(base, argc, argv, i);
+        if (consumed > 0) {
+            i += consumed - 1;
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--rounds") == 0 && std::atol(value) > 0) {
+            rounds = std::atol(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--threads") == 0 && std::atoi(value) > 0) {
+            threads = std::atoi(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--processes") == 0 && std::atoi(value) > 0) {
+            processes = std::atoi(argv[++i]);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--seed") == 0) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (consumed == 0 && value && std::strcmp(argv[i], "--cache") == 0) {
+            cacheDirectory = argv[++i];
+        } else if (consumed == 0 && std::strcmp(argv[i], "--no-cache") == 0) {
+            useCache = false;
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    // Every combination of the axes, the first axis varying slowest.
+    std::vector<Cell> cells(1);
+    cells[0].rules = base;
+    for (const Axis& axis : axes) {
+        std::vector<Cell> expanded;
+        for (const Cell& cell : cells) {
+            for (const std::vector<std::string>& options : axis.values) {
+                Cell next = cell;
+                if (!applyOptions(next.rules, options)) {
+                    std::fprintf(stderr, "bjsim: invalid sweep value %s\n", options.back().c_str());
+                    return 2;
+                }
+                expanded.push_back(next);
+            }
+        }
+        cells.swap(expanded);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ResultCache cache(cacheDirectory);
+    std::vector<Shard> shards;
+    std::size_t computed = 0;
+    for (int index = 0; index < (int) cells.size(); ++index) {
+        Cell& cell = cells[index];
+        std::string text;
+        cell.cached = useCache && cache.load("sweep", cell.rules.hash(), text)
+            && parseCell(text, rounds, seed, cell);
+        if (cell.cached) {
+            continue;
+        }
+        cell.rounds = rounds;
+        cell.parts.resize((rounds + SHARD_ROUNDS - 1) / SHARD_ROUNDS);
+        cell.remaining = (int) cell.parts.size();
+        for (int part = 0; part < (int) cell.parts.size(); ++part) {
+            long shardRounds = std::min(SHARD_ROUNDS, rounds - part * SHARD_ROUNDS);
+            shards.push_back(Shard{index, part, shardRounds, estimateCost(cell.rules, shardRounds)});
+        }
+        ++computed;
+    }
+
+    // Most expensive shards first, ties in cell and shard order.
+    auto lowerPriority = [&](int left, int right) {
+        double leftCost = shards[left].cost;
+        double rightCost = shards[right].cost;
+        return leftCost != rightCost ? leftCost < rightCost : left > right;
+    };
+    std::priority_queue<int, std::vector<int>, decltype(lowerPriority)> queue(lowerPriority);
+    for (int index = 0; index < (int) shards.size(); ++index) {
+        queue.push(index);
+    }
+    std::vector<int> order;
+    for (; !queue.empty(); queue.pop()) {
+        order.push_back(queue.top());
+    }
+
+    auto runShard = [&](int index) {
+        const Shard& shard = shards[index];
+        const Cell& cell = cells[shard.cell];
+        std::uint64_t cellSeed = streamSeed(seed, cell.rules.hash());
+        return withRules(cell.rules, [&](const auto& policy) {
+            return playCell(policy, shard.rounds, streamSeed(cellSeed, shard.part));
+        });
+    };
+    // Completes a cell once all its shards are in, combining them in order.
+    auto finishShard = [&](int index, const RunningStats *results) {
+        const Shard& shard = shards[index];
+        Cell& cell = cells[shard.cell];
+        if (results) {
+            cell.parts[shard.part] = *results;
+        } else {
+            ++cell.lost;
+        }
+        if (--cell.remaining > 0 || cell.lost > 0) {
+            return;
+        }
+        for (const RunningStats& part : cell.parts) {
+            cell.results.merge(part);
+        }
+        if (useCache && !cache.store("sweep", cell.rules.hash(), formatCell(cell.results, rounds, seed))) {
+            std::fprintf(stderr, "bjsim: could not write to the cache in %s\n", cache.directory().c_str());
+        }
+    };
+
+    if (processes > 0) {
+        runShardsInProcesses(order, processes, SHARD_ATTEMPTS,
+            [&](int index) {
+                SnapshotWriter snapshot;
+                snapshot.put(runShard(index).state());
+                return snapshot.data();
+            },
+            [&](int index, const std::string *data) {
+                if (data == nullptr) {
+                    finishShard(index, nullptr);
+                    return;
+                }
+                RunningStats::State state;
+                SnapshotReader snapshot(*data);
+                bool complete = snapshot.get(state) && snapshot.atEnd();
+                RunningStats results = RunningStats::fromState(state);
+                finishShard(index, complete ? &results : nullptr);
+            });
+    } else {
+        std::mutex mutex;
+        std::atomic<std::size_t> next(0);
+        auto work = [&]() {
+            for (std::size_t position = next++; position < order.size(); position = next++) {
+                RunningStats results = runShard(order[position]);
+                std::lock_guard<std::mutex> lock(mutex);
+                finishShard(order[position], &results);
+            }
+        };
+        std::vector<std::thread> workers;
+        for (int index = 1; index < std::min<int>(threads, (int) order.size()); ++index) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("cells: %zu, %ld rounds each, seed %llu\n", cells.size(), rounds, (unsigned long long) seed);
+    std::printf("rules                                      house edge\n");
+    for (const Cell& cell : cells) {
+        if (cell.lost > 0) {
+            std::printf("%-40s incomplete: %d of %zu shards lost\n", cell.rules.describe().c_str(), cell.lost,
+                        cell.parts.size());
+            continue;
+        }
+        std::printf("%-40s %+8.4f%% +/- %.4f%%", cell.rules.describe().c_str(), -100.0 * cell.results.mean(),
+                    100.0 * cell.results.confidenceHalfWidth());
+        if (cell.cached && cell.rounds != rounds) {
+            std::printf("  (cached, %ld rounds)", cell.rounds);
+        } else if (cell.cached) {
+            std::printf("  (cached)");
+        }
+        std::printf("\n");
+    }
+    std::printf("computed %zu of %zu cells, elapsed: %.3f s\n", computed, cells.size(), seconds);
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "headers/cards.h"
+#include "headers/qtadapter.h"
 
 /**
  * @file Cards.cpp
@@ -33,6 +34,17 @@ cards::cards(GameUI* gameUI, MultiDeck& deck, QWidget *parent) : QDialog(parent)
     titleLabel->setFont(titleFont);
     layout->addWidget(titleLabel);
 
+    // running and true count of every counting system over the cards seen this shoe
+    QString countText = QString("Cards seen: %1 (%2 decks left)")
+        .arg(deck.counts.cardsSeen()).arg(deck.counts.decksRemaining(), 0, 'f', 2);
+    for (int system = 0; system < COUNT_SYSTEMS; ++system) {
+        CountingSystem counting = CountingSystem(system);
+        countText += QString("\n%1: RC %2, TC %3").arg(CardCounter::systemName(counting))
+            .arg(deck.counts.runningCount(counting)).arg(deck.counts.trueCount(counting), 0, 'f', 2);
+    }
+    QLabel *countLabel = new QLabel(countText, this);
+    layout->addWidget(countLabel);
+
     layout->addSpacerItem(new QSpacerItem(20, 40, QSizePolicy::Minimum, QSizePolicy::Expanding));
 
 
@@ -57,7 +69,7 @@ cards::cards(GameUI* gameUI, MultiDeck& deck, QWidget *parent) : QDialog(parent)
 
     // Set window properties
     setWindowTitle("BlackJack Simulator");
-    setFixedSize(200, 200); // Adjust size as needed
+    setFixedSize(240, 330); // Adjust size as needed
 
 
 
@@ -81,8 +93,8 @@ void cards::showDeck() {
     QGridLayout *layout = new QGridLayout(container);
 
     int cardsPerRow = 13;
-    for (int i = 0; i < 312; ++i) {
-        QString imagePath = multideck.allDecks[i].imagePath(); // Get the image path
+    for (int i = 0; i < multideck.size(); ++i) {
+        QString imagePath = cardImagePath(multideck.allDecks[i]); // Get the image path
         QLabel *cardLabel = new QLabel;
         QPixmap pixmap(imagePath);
         cardLabel->setPixmap(pixmap.scaled(60, 100, Qt::KeepAspectRatio)); // Resize image
@@ -115,7 +127,7 @@ void cards::showDeck() {
 void cards::onDrawCardClicked() {
 
     Card drawnCard = multideck.drawCard();
-    QString cardDescription = drawnCard.PrintCard2();
+    QString cardDescription = cardText(drawnCard);
 
     QMessageBox::information(this, "Drawn Card", "A card has been drawn:\n" + cardDescription);
 
@@ -148,8 +160,8 @@ void cards::showRemainingDeck() {
     QGridLayout *layout = new QGridLayout(container);
 
     int cardsPerRow = 13;
-    for (unsigned long long i = 0; i < (312- multideck.drawnCards.size()); ++i) {
-        QString imagePath = multideck.allDecks[i].imagePath(); // Get the image path
+    for (int i = 0; i < multideck.remaining(); ++i) {
+        QString imagePath = cardImagePath(multideck.allDecks[multideck.nextCard + i]); // Get the image path
         QLabel *cardLabel = new QLabel;
         QPixmap pixmap(imagePath);
         cardLabel->setPixmap(pixmap.scaled(60, 100, Qt::KeepAspectRatio)); // Resize image
@@ -190,7 +202,7 @@ void cards::displayDrawnCards() {
 
     int cardsPerRow = 13;
     for (unsigned long long i = 0; i < (multideck.drawnCards.size()); ++i) {
-        QString imagePath = multideck.drawnCards[i].imagePath();
+        QString imagePath = cardImagePath(multideck.drawnCards[i]);
         QLabel *cardLabel = new QLabel;
         QPixmap pixmap(imagePath);
         cardLabel->setPixmap(pixmap.scaled(60, 100, Qt::KeepAspectRatio)); // Resize image
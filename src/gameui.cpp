@@ -3,11 +3,14 @@
 #include <QPalette>
 #include <QVBoxLayout>
 #include <QLabel>
-#include <iostream>
+#include "headers/log.h"
+#include "headers/trace.h"
+#include "headers/metrics.h"
 #include <utility>
 #include <QMessageBox>
 #include <QString>
 #include "headers/cards.h"
+#include "headers/qtadapter.h"
 /**
  * @file GameUI.cpp
  * @brief Implementation of the GameUI class.
@@ -27,14 +30,16 @@
  *
  * Initializes the game user interface, setting up the deck, players, and UI components.
  */
-GameUI::GameUI(QWidget *parent, wallet* passedWallet) : QWidget(parent), myWallet(passedWallet) {
+GameUI::GameUI(QWidget *parent, wallet* passedWallet) : QWidget(parent), table(&multideck), myWallet(passedWallet) {
 
     setupUI();
 }
 
 
 
-GameUI::~GameUI() {}
+GameUI::~GameUI() {
+    delete advisor; // joins the worker before any widget it reports to goes away
+}
 
 
 /**
@@ -49,15 +54,9 @@ void GameUI::setupUI() {
     set_table_background(); // set table background
 
 
+    multideck.setDeckCount(rules.decks);
     multideck.createAndShuffleDecks();
 
-    QStringList imagePaths;
-    int size = 312;
-    for (int i = 0; i < size; ++i) {
-        imagePaths.append(multideck.allDecks[i].imagePath());
-    }
-
-
     // creating player and dealer
     dealer = new class dealer(&multideck);
 
@@ -66,18 +65,18 @@ void GameUI::setupUI() {
     hitButton = new QPushButton("Hit", this);
     standButton = new QPushButton("Stand", this);
     doubleButton = new QPushButton("Double", this);
+    splitButton = new QPushButton("Split", this);
     endHandButton = new QPushButton("End Hand", this);
     backToMenu = new QPushButton("Stats", this);
 
-    addPlayer1 = new QPushButton("Add player 1", this);
-    addPlayer2 = new QPushButton("Add player 2", this);
-    addPlayer3 = new QPushButton("Add player 3", this);
+    addPlayerButton = new QPushButton("Add Player", this);
 
     // set button sizes
     dealButton->setFixedSize(100, 40);
     hitButton->setFixedSize(50, 40);
     standButton->setFixedSize(50, 40);
     doubleButton->setFixedSize(60, 40);
+    splitButton->setFixedSize(50, 40);
     endHandButton->setFixedSize(100, 40);
     backToMenu->setFixedSize(100, 40);
 
@@ -85,32 +84,29 @@ void GameUI::setupUI() {
     hitButton->setStyleSheet("QPushButton { border: 2px solid black; background-color: #FF9999; color: black; }");
     standButton->setStyleSheet("QPushButton { border: 2px solid black; background-color: #90C5EB; color: black; }");
     doubleButton->setStyleSheet("QPushButton { border: 2px solid black; background-color: #58F470; color: black; }");
+    splitButton->setStyleSheet("QPushButton { border: 2px solid black; background-color: #FFD966; color: black; }");
     endHandButton->setStyleSheet("QPushButton { border: 2px solid black; background-color: #B9B0B0; color: black; }");
     backToMenu->setStyleSheet("QPushButton { border: 2px solid black; background-color: #90C5EB; color: black;}");
 
-    addPlayer1->setStyleSheet("QPushButton { border: 2px solid black; background-color: #BA68C8; color: black;}");
-    addPlayer2->setStyleSheet("QPushButton { border: 2px solid black; background-color: #CE93D8; color: black;}");
-    addPlayer3->setStyleSheet("QPushButton { border: 2px solid black; background-color: #E1BEE7; color: black;}");
+    addPlayerButton->setStyleSheet("QPushButton { border: 2px solid black; background-color: #BA68C8; color: black;}");
 
 
-    addPlayer1->setFixedSize(100,40);
-    addPlayer2->setFixedSize(100,40);
-    addPlayer3->setFixedSize(100,40);
+    addPlayerButton->setFixedSize(120,40);
 
     // Edit button's intial visibility
     hitButton->hide(); // Hide initially
     standButton->hide();
     doubleButton->hide();
+    splitButton->hide();
     endHandButton->hide();
 
     connect(dealButton, &QPushButton::clicked, this, &GameUI::onDealClicked);
     connect(endHandButton, &QPushButton::clicked, this, &GameUI::onEndClicked);
     connect(standButton, &QPushButton::clicked, this, &GameUI::onStandClicked);
     connect(doubleButton, &QPushButton::clicked, this, &GameUI::onDoubleClicked);
+    connect(splitButton, &QPushButton::clicked, this, &GameUI::onSplitClicked);
 
-    connect(addPlayer1, &QPushButton::clicked, this, &GameUI::onAddPlayer1Clicked);
-    connect(addPlayer2, &QPushButton::clicked, this, &GameUI::onAddPlayer2Clicked);
-    connect(addPlayer3, &QPushButton::clicked, this, &GameUI::onAddPlayer3Clicked);
+    connect(addPlayerButton, &QPushButton::clicked, this, &GameUI::onAddPlayerClicked);
 
     buttonsLayout = new QHBoxLayout(); // No longer a local variable
 
@@ -118,12 +114,11 @@ void GameUI::setupUI() {
     buttonsLayout->addWidget(hitButton);
     buttonsLayout->addWidget(standButton);
     buttonsLayout->addWidget(doubleButton);
+    buttonsLayout->addWidget(splitButton);
     buttonsLayout->addWidget(endHandButton);
     buttonsLayout->addWidget(backToMenu);
 
-    buttonsLayout->addWidget(addPlayer1);
-    buttonsLayout->addWidget(addPlayer2);
-    buttonsLayout->addWidget(addPlayer3);
+    buttonsLayout->addWidget(addPlayerButton);
 
     buttonsLayout->setAlignment(Qt::AlignBottom);
     buttonsLayout->setContentsMargins(30, 0, 0, 100); // Left, Top, Right, Bottom margins
@@ -152,19 +147,30 @@ void GameUI::setupUI() {
 
     // Player and Dealer hand points
     QVBoxLayout *buttonsLayout3 = new QVBoxLayout();
-    QVBoxLayout *buttonsLayout4 = new QVBoxLayout();
 
-    playerHandValue1 = new QLabel(this);
-    playerHandValue1->move(100,400);
-    playerHandValue1->setMinimumWidth(750); // Set a minimum width to accommodate the text
-    buttonsLayout4->addWidget(playerHandValue1);
-    buttonsLayout4->setAlignment(Qt::AlignLeft);
+    // one label per seat, placed under the seat by displayPlayerHandsValue
+    for (int i = 0; i < MAX_SEATS; i++){
+        seatHandValues[i] = new QLabel(this);
+        seatHandValues[i]->hide();
+    }
+
+    // action values for the hand being played, worked out off the GUI thread
+    advisor = new Advisor(rules, [this](const AdvisorQuery &query, const ActionValues &values) {
+        QMetaObject::invokeMethod(this, [this, query, values]() {
+            if (query.key() == adviceKey) {
+                showAdvice(values);
+            }
+        }, Qt::QueuedConnection);
+    });
+    adviceLabel = new QLabel(this);
+    adviceLabel->setStyleSheet("QLabel { color : white; background-color: rgba(0, 0, 0, 120); padding: 4px; }");
+    adviceLabel->hide();
 
     dealerHandValue = new QLabel(this);
     dealerHandValue->move(50,200);
     dealerHandValue->setMinimumWidth(200); // Set a minimum width to accommodate the text
 
-    QString dealerHandString = dealer->GetHandString(); // Get the hand string from player1
+    QString dealerHandString = dealerHandText(dealer->GetHandValue());
     dealerHandValue->setText(dealerHandString);
 
     buttonsLayout3->addWidget(dealerHandValue);
@@ -243,16 +249,22 @@ void GameUI::set_table_background() {
  * round, including dealing cards and adjusting the wallet according to the bet amount.
  */
 void GameUI::onDealClicked() {
+    TRACE_SCOPE("GameUI::onDealClicked");
+    METRICS_TIME(metrics::dealLatency);
     setupComplete = false;
-    if (playerNum == 0){
+    bool dealt = false;
+    if (table.seatCount == 0){
         return;
     }
+    if (multideck.needsShuffle(rules.penetration)) {
+        multideck.createAndShuffleDecks(); // cut card reached
+    }
     // subtract bet amount from wallet on deal clicked
     bool ok;
     double doubleBetAmount = betAmount->text().toDouble(&ok);
     if (ok && doubleBetAmount>0) {
 
-        bool place_bet_success = myWallet->placeBet(doubleBetAmount * playerNum);
+        bool place_bet_success = myWallet->placeBet(doubleBetAmount * table.seatCount);
         if (place_bet_success) {
             updateWalletBalanceLabel();
             // display or hide buttons on screen
@@ -263,33 +275,49 @@ void GameUI::onDealClicked() {
             bet_amount_slider->hide();
             backToMenu->hide();
 
-            addPlayer1->hide();
-            addPlayer2->hide();
-            addPlayer3->hide();
+            addPlayerButton->hide();
 
             // start game - initial dealing of cards
             dealerSetup();
-            for (int i = 0; i < playerNum; i++){
+            for (int i = 0; i < table.seatCount; i++){
                 onHitClicked();
                 onHitClicked();
                 currentPlayingHand ++;
             }
             displayPlayerHandsValue();
-            playerHandValue1->show();
             currentPlayingHand = 0;
+            dealt = true;
         } else {
             QMessageBox::warning(this, "Invalid Bet", "Please enter a valid bet amount.");
         }
     }
 
     setupComplete = true;
-    checkBJ();
-    if (skiphand == 0){
-        buttonsLayout->setContentsMargins(300, 0, 0, 100); // Left, Top, Right, Bottom margins
-        std::cout << "        NEWEST CHECK: this is used = "<< currentPlayingHand << std::endl;
+    if (!dealt){
+        return;
+    }
 
-        currentPlayingHand ++;
-        skiphand = -1;
+    if (dealer->GetUpcardValue() == 11){
+        offerInsurance();
+    }
+    // Under peek rules the dealer checks an ace or ten upcard for blackjack before anyone
+    // acts, so a dealer blackjack ends the round here.
+    if (rules.dealerPeek && dealer->HasBlackjack()){
+        hidePlayerActionButtons();
+        showFaceDownCard();
+        QMessageBox::information(this, "Dealer Blackjack", "The dealer checked the hole card and has blackjack.");
+        displayResult();
+        onEndClicked();
+        return;
+    }
+
+    checkBJ();
+    if (currentPlayingHand < table.seatCount){
+        moveButtonsToSeat(currentPlayingHand);
+        updateActionButtons();
+    }
+    else{
+        finishRound(); // every seat has blackjack
     }
 }
 
@@ -301,11 +329,13 @@ void GameUI::onDealClicked() {
  * comparing hands between the dealer and players to determine the outcome.
  */
 void GameUI::onEndClicked() {
+    METRICS_TIME(metrics::endRoundLatency);
 
     // manipulating buttons
     hitButton->hide();
     standButton->hide();
     doubleButton->hide();
+    splitButton->hide();
     endHandButton->hide();
     dealButton->show();
     enter_bet_amount_label->show();
@@ -313,50 +343,49 @@ void GameUI::onEndClicked() {
     bet_amount_slider->show();
     backToMenu->show();
 
-    addPlayer1->show();
-    addPlayer2->show();
-    addPlayer3->show();
-
-    addPlayer1->setEnabled(true);
-    addPlayer2->setEnabled(true);
-    addPlayer3->setEnabled(true);
-
-    addPlayer1->setText("Add Player 1");
-    addPlayer2->setText("Add Player 2");
-    addPlayer3->setText("Add Player 2");
+    addPlayerButton->show();
+    addPlayerButton->setEnabled(true);
+    addPlayerButton->setText("Add Player");
 
     // updating wallet balance based on win, lose, tie
-
-    for (player* p : players) {
-        int result = dealer->CompareHands(*p);
-        if (result == 0) {/**updateWalletBalanceLabel();**/} // if dealer wins wallet already subtracted, do nothing
-        else if (result == 1 ){ // if player wins hand
-            bool ok;
-            double initialBetAmount = betAmount->text().toDouble(&ok);
-            if (ok && initialBetAmount>0) {
-                double winnings = p->isDoubled ? 4 * initialBetAmount : 2 * initialBetAmount;
-
-                    myWallet->addFunds(winnings);
-                updateWalletBalanceLabel();
-            }
+    TRACE_SCOPE("settle");
+    bool ok;
+    double initialBetAmount = betAmount->text().toDouble(&ok);
+    for (int i = 0; i < table.seatCount; i++) {
+        player *p = &table.seats[i];
+        metrics::handsPlayed.add();
+        if (!ok || initialBetAmount <= 0) {
+            continue;
+        }
+        if (p->insured && p->HasBlackjack()) {
+            myWallet->addFunds(2 * initialBetAmount); // even money, whatever the dealer has
+            updateWalletBalanceLabel();
+            continue;
         }
-        else{ // tie game
-            bool ok;
-            double initialBetAmount = betAmount->text().toDouble(&ok);
-            if (ok && initialBetAmount>0) {
-                double winnings = p->isDoubled ? 2 * initialBetAmount : 1 * initialBetAmount;
-
-                    myWallet->addFunds(winnings);
-                updateWalletBalanceLabel();
+        if (p->insured && dealer->HasBlackjack()) {
+            myWallet->addFunds(1.5 * initialBetAmount); // half-bet insurance returned and paid 2:1
+        }
+        for (int h = 0; h < p->handCount; h++) {
+            const Hand &hand = p->hands[h];
+            double stake = hand.bet * initialBetAmount; // bet is 2 on a doubled hand
+            HandOutcome result = dealer->CompareHands(hand);
+            if (result == OUTCOME_LOSE) {/**updateWalletBalanceLabel();**/} // if dealer wins wallet already subtracted, do nothing
+            else if (result == OUTCOME_WIN){ // if player wins hand
+                double winnings = hand.isNatural() ? stake + stake * rules.blackjackPayout() : 2 * stake;
+                myWallet->addFunds(winnings);
+            }
+            else{ // tie game
+                myWallet->addFunds(stake);
             }
         }
+        updateWalletBalanceLabel();
     }
 
     updateSliderRange();
+    countHoleCard(); // seen at the latest as the cards are cleared
     resetPlayerHand();
     resetDealerHand();
 
-    playerHandValue1->hide();
     currentPlayingHand = 0;
 
     buttonsLayout->setContentsMargins(30, 0, 0, 100); // Left, Top, Right, Bottom margins
@@ -404,26 +433,42 @@ void GameUI::updateWalletBalanceLabel() {
 
 
 /**
- * @brief Responds to the Hit button click by the current player.
- *
- * This method deals an additional card to the current player's hand and updates
- * the UI accordingly. It also checks for conditions such as busts or blackjack
- * and ends the hand if necessary.
+ * @brief Left edge of a seat's cards.
+ * @param seat Index of the seat in table.
+ * @return The x-coordinate, spreading the seats in play evenly across the window.
  */
-void GameUI::onHitClicked(){
+int GameUI::seatX(int seat) const {
+    int seatWidth = (width() - 100) / qMax(1, table.seatCount);
+    return 50 + seat * seatWidth;
+}
 
-    player *currentPlayer = players[currentPlayingHand];
-    currentPlayer->Hit();
-    int position_index = currentPlayingHand;
-    int xPosition = 50 + position_index * 320; // Initial x-coordinate for the first image
 
-    if(currentPlayer->hand.size()== 3){
-        doubleButton->hide();
-    }
+/**
+ * @brief Moves the action buttons under the seat whose turn it is.
+ * @param seat Index of the seat in table.
+ */
+void GameUI::moveButtonsToSeat(int seat){
+    buttonsLayout->setContentsMargins(qMax(30, seatX(seat) - 20), 0, 0, 100); // Left, Top, Right, Bottom margins
+}
 
-    ///loop through players and display their card images
-    for (unsigned long long i = 0; i < currentPlayer->hand.size(); i++){
-        QString imagePath = currentPlayer->hand[i].generateImagePath(); // Get the image path for the current card
+
+/**
+ * @brief Draws the card images of one of a seat's hands.
+ * @param seat Index of the seat in table.
+ * @param handIndex Index of the hand within the seat.
+ *
+ * The first hand of each seat sits on the seat's row; every further split hand is drawn
+ * a little lower and to the right so the hands of a seat fan out without hiding each other.
+ */
+void GameUI::drawPlayerHand(int seat, int handIndex){
+    const Hand &hand = table.seats[seat].hands[handIndex];
+    int xPosition = seatX(seat) + handIndex * 20; // Initial x-coordinate for the first image
+    int yPosition = 250 + handIndex * 45;
+    int cardStep = qMin(50, (width() - 100) / qMax(1, table.seatCount) / 5); // cards overlap more at a full table
+
+    ///loop through the hand and display its card images
+    for (int i = 0; i < hand.count; i++){
+        QString imagePath = cardImagePath(hand.cards[i]); // Get the image path for the current card
         QPixmap pixmap(imagePath);
         QSize newSize  = pixmap.size()*2;
         QPixmap scaledPixmap = pixmap.scaled(newSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
@@ -432,32 +477,159 @@ void GameUI::onHitClicked(){
         QLabel *imageLabel = new QLabel(this);
         imageLabel->setPixmap(scaledPixmap);
         imageLabel->setFixedSize(scaledPixmap.size());
-        imageLabel->move(xPosition, 250);
-        xPosition += 50;
+        imageLabel->move(xPosition, yPosition);
+        xPosition += cardStep;
         imageLabel->show();
         playerHandImages.append(imageLabel);
     }
+}
+
+
+/**
+ * @brief Shows only the actions the rules allow on the current player's active hand.
+ *
+ * Double needs a two-card hand, and after a split also needs DAS. Split aces that may not
+ * draw can only stand, or split again when resplitting aces is allowed.
+ */
+void GameUI::updateActionButtons(){
+    player *currentPlayer = &table.seats[currentPlayingHand];
+    const Hand &hand = currentPlayer->CurrentHand();
+    bool drawsOneCard = hand.isSplitAces() && !rules.hitSplitAces;
+
+    hitButton->setVisible(!drawsOneCard);
+    doubleButton->setVisible(hand.count == 2 && !drawsOneCard && (!hand.fromSplit || rules.doubleAfterSplit));
+    splitButton->setVisible(currentPlayer->CanSplit(rules.maxSplitHands, rules.resplitAces));
+    requestAdvice();
+}
+
+
+/**
+ * @brief The decision facing the current player's active hand, as the player sees it.
+ *
+ * Every card on the table is out of the unseen shoe except the dealer's hole card.
+ */
+AdvisorQuery GameUI::currentQuery() const {
+    const Hand &hand = table.seats[currentPlayingHand].CurrentHand();
+    AdvisorQuery query;
+    query.shoe = ShoeComposition::remainingIn(multideck);
+    query.shoe.add(rankIndex(dealer->hand[0]));
+    query.upcard = rankIndex(dealer->hand[1]);
+    for (int i = 0; i < hand.count; i++){
+        query.addCard(hand.cards[i]);
+    }
+    query.fromSplit = hand.fromSplit;
+    return query;
+}
+
+
+/**
+ * @brief Shows the action values for the current decision, or starts working them out.
+ *
+ * A situation seen before is shown at once. Otherwise the label is blanked until the
+ * advisor's answer arrives, usually within a few tens of milliseconds; an answer for an
+ * earlier decision is ignored.
+ */
+void GameUI::requestAdvice(){
+    HandValue handValue = table.seats[currentPlayingHand].GetHandValue();
+    if (handValue.bust || handValue.total == 21){
+        clearAdvice(); // the hand is about to end
+        return;
+    }
+
+    AdvisorQuery query = currentQuery();
+    adviceKey = query.key();
+
+    ActionValues values;
+    if (advisor->lookup(query, values)){
+        showAdvice(values);
+    }
+    else{
+        adviceLabel->setText("EV: ...");
+        adviceLabel->adjustSize();
+        advisor->request(query);
+    }
+    adviceLabel->move(qMax(30, seatX(currentPlayingHand) - 20), height() - 200);
+    adviceLabel->show();
+}
+
+
+/**
+ * @brief Fills the advice label with the value of every action the buttons offer.
+ * @param values Expected values per unit bet; the best one listed is shown in bold.
+ */
+void GameUI::showAdvice(const ActionValues &values){
+    struct Entry { const char *name; double value; };
+    QVector<Entry> offered;
+    offered.append({"Stand", values.stand});
+    if (hitButton->isVisible()){
+        offered.append({"Hit", values.hit});
+    }
+    if (doubleButton->isVisible() && values.canDouble){
+        offered.append({"Double", values.doubleDown});
+    }
+    if (splitButton->isVisible() && values.canSplit){
+        offered.append({"Split", values.split});
+    }
+
+    // Only listed actions compete: surrender has no button, and split aces hide Hit.
+    int best = 0;
+    for (int i = 1; i < offered.size(); ++i){
+        if (offered[i].value > offered[best].value){
+            best = i;
+        }
+    }
+    QStringList entries;
+    for (int i = 0; i < offered.size(); ++i){
+        QString text = QString("%1 %2").arg(offered[i].name).arg(offered[i].value, 0, 'f', 3);
+        entries << (i == best ? "<b>" + text + "</b>" : text);
+    }
+    adviceLabel->setText("EV: " + entries.join("&nbsp;&nbsp;"));
+    adviceLabel->adjustSize();
+}
+
+
+/**
+ * @brief Hides the advice label and stops any calculation for it.
+ */
+void GameUI::clearAdvice(){
+    advisor->cancel();
+    adviceKey = CompositionKey{};
+    adviceLabel->hide();
+}
+
+
+/**
+ * @brief Responds to the Hit button click by the current player.
+ *
+ * This method deals an additional card to the current player's active hand and updates
+ * the UI accordingly. It also checks for a bust or a total of 21 and ends the hand
+ * if necessary.
+ */
+void GameUI::onHitClicked(){
+    TRACE_SCOPE("GameUI::onHitClicked");
+    METRICS_TIME(metrics::hitLatency);
+
+    player *currentPlayer = &table.seats[currentPlayingHand];
+    currentPlayer->Hit();
+    drawPlayerHand(currentPlayingHand, currentPlayer->activeHand);
     displayPlayerHandsValue();
 
 
-    QString handString = currentPlayer->GetHandString();
-    std::cout << "Current playerNum = "<< playerNum<< std::endl;
-    std::cout << "Current playing hand:  = "<< currentPlayingHand << std::endl;
+    HandValue handValue = currentPlayer->GetHandValue();
+    QString handString = playerHandText(handValue);
+    LOG_DEBUG("Current seat count = %d, current playing hand = %d", table.seatCount, currentPlayingHand);
 
 
     if(setupComplete == true){
+        updateActionButtons();
         // if player busts
-        if (currentPlayer->CheckHand().first>21){
+        if (handValue.bust){
             QMessageBox::information(this, "BUST", "Your hand exceeds 21. You lose.\n\nYour Hand: " + handString);
             endHand();
         }
-        else if (((currentPlayer->CheckHand().first == 11)&&(player1->CheckHand().second==21))&&(dealer->CheckHand().second != 21)){
-            QMessageBox::information(this, "WIN", "BLACK JACK!. You win!");
-            endHand();
-        }
-        // if Player wins hand
-        else if ((currentPlayer->CheckHand().first == 21)||(player1->CheckHand().second==21)){
-            QMessageBox::information(this, "WIN", "Congradulation. You win!");
+        // nothing left to draw to
+        else if (handValue.total == 21){
+            QMessageBox::information(this, "21", "Your hand is 21.");
             endHand();
         }
     }
@@ -470,6 +642,7 @@ void GameUI::onHitClicked(){
  * and proceeds to the next actions, like revealing the dealer's hand or ending the hand.
  */
 void GameUI::onStandClicked(){
+    METRICS_TIME(metrics::standLatency);
     endHand();
 }
 
@@ -477,38 +650,74 @@ void GameUI::onStandClicked(){
 /**
  * @brief Doubles the player's bet and draws one final card.
  *
- * This method is triggered by the Double button. It doubles the current player's bet,
- * draws one additional card, and then ends the player's turn.
+ * This method is triggered by the Double button. It doubles the bet on the current
+ * player's active hand, draws one additional card, and then ends that hand.
  */
 void GameUI::onDoubleClicked() {
+    METRICS_TIME(metrics::doubleLatency);
 
-    player *currentPlayer = players[currentPlayingHand];
-    currentPlayer->isDoubled = true;
-
+    player *currentPlayer = &table.seats[currentPlayingHand];
 
     bool ok;
     double doubleBetAmount = betAmount->text().toDouble(&ok);
     if (ok && doubleBetAmount>0) {
-        bool place_bet_success = myWallet->placeBet(doubleBetAmount);
+        bool place_bet_success = myWallet->placeBet(doubleBetAmount * currentPlayer->CurrentHand().bet);
         if (place_bet_success) {
 
 
             updateWalletBalanceLabel(); // update balance with subtracted double bet
-            int debug = currentPlayingHand;
-            onHitClicked(); // deal player 1 additional card
-            std::cout << "          Debug: "<< debug<< "    CPH: "<< currentPlayingHand << std::endl;
-            if (debug != currentPlayingHand){
-                return;
-            }
-            else{
-                endHand();
+            currentPlayer->Double(); // deal player 1 additional card
+            drawPlayerHand(currentPlayingHand, currentPlayer->activeHand);
+            displayPlayerHandsValue();
+            LOG_DEBUG("Doubled on hand %d", currentPlayingHand);
+
+            HandValue handValue = currentPlayer->GetHandValue();
+            if (handValue.bust){
+                QMessageBox::information(this, "BUST", "Your hand exceeds 21. You lose.\n\nYour Hand: " + playerHandText(handValue));
             }
+            endHand();
         } else {
             QMessageBox::warning(this, "Invalid Bet", "Please enter a valid bet amount.");
         }
     }
 }
 
+
+/**
+ * @brief Splits the current player's pair into two hands.
+ *
+ * This method is triggered by the Split button. It places a second bet equal to the first,
+ * moves the second card of the pair to a new hand and deals one card to each hand. Split
+ * aces that may not draw are finished straight away.
+ */
+void GameUI::onSplitClicked() {
+    player *currentPlayer = &table.seats[currentPlayingHand];
+    if (!currentPlayer->CanSplit(rules.maxSplitHands, rules.resplitAces)) {
+        return;
+    }
+
+    bool ok;
+    double splitBetAmount = betAmount->text().toDouble(&ok);
+    if (ok && splitBetAmount>0 && myWallet->placeBet(splitBetAmount * currentPlayer->CurrentHand().bet)) {
+        updateWalletBalanceLabel(); // update balance with subtracted split bet
+        currentPlayer->Split();
+        drawPlayerHand(currentPlayingHand, currentPlayer->activeHand);
+        drawPlayerHand(currentPlayingHand, currentPlayer->handCount - 1);
+        displayPlayerHandsValue();
+        LOG_DEBUG("Split hand %d into %d hands", currentPlayingHand, currentPlayer->handCount);
+
+        const Hand &hand = currentPlayer->CurrentHand();
+        if (hand.isSplitAces() && !rules.hitSplitAces
+            && !currentPlayer->CanSplit(rules.maxSplitHands, rules.resplitAces)) {
+            endHand();
+        } else {
+            updateActionButtons();
+        }
+    } else {
+        QMessageBox::warning(this, "Invalid Bet", "Please enter a valid bet amount.");
+    }
+}
+
 /**
  * @brief Displays the result of the current hand.
  *
@@ -520,29 +729,44 @@ void GameUI::displayResult(){
     QString message;
     QString gameResult;
     \
-        int result;
-    gameResult += QString("Dealer value: %1: \n\n").arg(dealer->GetHandString());
-
-    for (int i = 0; i< playerNum; i++){
+        HandOutcome result;
+    gameResult += QString("Dealer value: %1: \n\n").arg(dealerHandText(dealer->GetHandValue()));
+
+    for (int i = 0; i< table.seatCount; i++){
+        if (table.seats[i].insured && table.seats[i].HasBlackjack()){
+            message += QString("Hand %1: Even money\n").arg(i + 1);
+            gameResult += QString("     Hand value: %1: Even money\n").arg(playerHandText(table.seats[i].hands[0].value()));
+            continue;
+        }
+        if (table.seats[i].insured){
+            message += QString("Hand %1 insurance: %2\n").arg(i + 1).arg(dealer->HasBlackjack() ? "Win" : "Lose");
+        }
+        for (int h = 0; h < table.seats[i].handCount; h++){
+            const Hand &hand = table.seats[i].hands[h];
+            result = dealer->CompareHands(hand);
 
-        result = dealer->CompareHands(*players[i]);
+            QString handName = QString::number(i + 1);
+            if (table.seats[i].handCount > 1){
+                handName += QString(".%1").arg(h + 1); // split hands are numbered 1.1, 1.2, ...
+            }
+            QString handString = playerHandText(hand.value());
 
-        if (result == 0){
-            message += QString("Hand %1: Lose\n").arg(i + 1);
-            gameResult += QString("     Hand value: %1: Lose\n").arg(players[i]->GetHandString());
+            if (result == OUTCOME_LOSE){
+                message += QString("Hand %1: Lose\n").arg(handName);
+                gameResult += QString("     Hand value: %1: Lose\n").arg(handString);
 
-        }
-        else if (result == 1 ){
-            message += QString("Hand %1: Win\n").arg(i + 1);
-            gameResult += QString("     Hand value: %1: Win\n").arg(players[i]->GetHandString());
+            }
+            else if (result == OUTCOME_WIN){
+                message += QString("Hand %1: Win\n").arg(handName);
+                gameResult += QString("     Hand value: %1: Win\n").arg(handString);
 
-        }
-        else{
-            message += QString("Hand %1: Tie\n").arg(i + 1);
-            gameResult += QString("     Hand value: %1: Tie\n").arg(players[i]->GetHandString());
+            }
+            else{
+                message += QString("Hand %1: Tie\n").arg(handName);
+                gameResult += QString("     Hand value: %1: Tie\n").arg(handString);
 
+            }
         }
-
     }
 
 
@@ -563,10 +787,11 @@ void GameUI::displayResult(){
  * including cards that were initially dealt face down.
  */
 void GameUI::dealerReveal(){
+    TRACE_SCOPE("GameUI::dealerReveal");
     int xPosition = 350; // Initial x-coordinate for the first image
     for (unsigned long long i = 2; i < dealer->hand.size(); i++){
         delay(100);
-        QString imagePath = dealer->hand[i].generateImagePath(); // Get the image path for the current card
+        QString imagePath = cardImagePath(dealer->hand[i]); // Get the image path for the current card
 
         QPixmap pixmap(imagePath);
         QSize newSize  = pixmap.size()*2;
@@ -584,7 +809,7 @@ void GameUI::dealerReveal(){
         dealerHandImages.append(imageLabel);
     }
 
-    QString handString = dealer->GetHandString(); // Get the hand string from player1
+    QString handString = dealerHandText(dealer->GetHandValue());
     dealerHandValue->setText(handString); // Update the text of the QLabel
 
 }
@@ -612,9 +837,10 @@ void GameUI::delay(int milliseconds) {
 void GameUI::dealerSetup(){
     dealer->Hit();
     dealer->Hit();
+    multideck.counts.forget(dealer->hand[0].value); // the hole card is dealt face down
+    holeCardCounted = false;
     showDealerCard();
-    QString HandValue = dealer->GetHandString_oneCard(); // Get the hand string from player1
-    dealerHandValue->setText(HandValue);
+    dealerHandValue->setText(QString::number(dealer->GetUpcardValue()));
 
 }
 
@@ -640,7 +866,7 @@ void GameUI::showDealerCard(){
     dealerHandImages.append(imageLabel2);
 
     //Face up Card
-    QString imagePath = dealer->hand[1].generateImagePath(); // Get the image path for the current card
+    QString imagePath = cardImagePath(dealer->hand[1]); // Get the image path for the current card
 
     QPixmap pixmap(imagePath);
     QSize newSize  = pixmap.size()*2;
@@ -655,13 +881,23 @@ void GameUI::showDealerCard(){
 
 
 
-    QString handString = dealer->GetHandString(); // Get the hand string from player1
+    QString handString = dealerHandText(dealer->GetHandValue());
     dealerHandValue->setText(handString); // Update the text of the QLabel
 
 }
 
 
 
+/**
+ * @brief Adds the dealer's hole card to the shoe's counts, once per round.
+ */
+void GameUI::countHoleCard(){
+    if (!holeCardCounted){
+        multideck.counts.observe(dealer->hand[0].value);
+        holeCardCounted = true;
+    }
+}
+
 /**
  * @brief Reveals the dealer's face down card.
  *
@@ -669,7 +905,8 @@ void GameUI::showDealerCard(){
  * to the player at the appropriate time.
  */
 void GameUI::showFaceDownCard(){
-    QString imagePath = dealer->hand[0].generateImagePath(); // Get the image path for the current card
+    countHoleCard();
+    QString imagePath = cardImagePath(dealer->hand[0]); // Get the image path for the current card
 
     QPixmap pixmap(imagePath);
     QSize newSize  = pixmap.size()*2;
@@ -685,7 +922,7 @@ void GameUI::showFaceDownCard(){
     int xPosition = 300; // Initial x-coordinate for the first image
 
 
-    QString imagePath2 = dealer->hand[1].generateImagePath(); // Get the image path for the current card
+    QString imagePath2 = cardImagePath(dealer->hand[1]); // Get the image path for the current card
 
     QPixmap pixmap2(imagePath2);
     QSize newSize2  = pixmap2.size()*2;
@@ -701,7 +938,7 @@ void GameUI::showFaceDownCard(){
     imageLabel2->show();
     dealerHandImages.append(imageLabel2);
 
-    QString handString = dealer->GetHandString(); // Get the hand string from player1
+    QString handString = dealerHandText(dealer->GetHandValue());
     dealerHandValue->setText(handString); // Update the text of the QLabel
 
 }
@@ -721,25 +958,15 @@ void GameUI::resetPlayerHand() {
     playerHandImages.clear(); // Clear the list of image labels
 
 
-    player *currentPlayer;
-
-    for (int i = 0; i < playerNum; i++){
-
-        currentPlayer = players[i];
-        currentPlayer->hand.clear();
-        currentPlayer->isDoubled = false;
+    // empty the table; players are seated again before the next deal
+    table.clear();
 
+    // Clear the seat hand values
+    for (QLabel *label : seatHandValues) {
+        label->clear();
+        label->hide();
     }
 
-    //clear player list
-    players.clear();
-
-    playerNum = 0;
-    skiphand = -1;
-
-    // Clear the text of playerHandValue1
-    playerHandValue1->clear();
-
 }
 
 
@@ -784,8 +1011,8 @@ void GameUI::onShowDeckClicked() {
     int cardsPerRow = 13;
 
     //loop through deck
-    for (unsigned long long i = 0; i < (312- multideck.drawnCards.size()); ++i) {
-        QString imagePath = multideck.allDecks[i].imagePath(); // Get the image path
+    for (int i = 0; i < multideck.remaining(); ++i) {
+        QString imagePath = cardImagePath(multideck.allDecks[multideck.nextCard + i]); // Get the image path
         QLabel *cardLabel = new QLabel;
         QPixmap pixmap(imagePath);
         cardLabel->setPixmap(pixmap.scaled(60, 100, Qt::KeepAspectRatio)); // Resize image
@@ -810,52 +1037,16 @@ void GameUI::onShowDeckClicked() {
 
 
 /**
- * @brief Adds the first player to the game.
- *
- * When the Add Player 1 button is clicked, this method creates a new player instance
- * and updates the UI and internal game state to include the new player.
- */
-void GameUI::onAddPlayer1Clicked(){
-
-    player1 = new class player(&multideck);
-    players.append(player1);
-
-    playerNum++;
-    addPlayer1->setText("+");
-    addPlayer1->setEnabled(false);
-
-}
-
-/**
- * @brief Adds the second player to the game.
- *
- * When the Add Player 2 button is clicked, this method creates a new player instance
- * and updates the UI and internal game state to include the new player.
- */
-void GameUI::onAddPlayer2Clicked(){
-
-    player2 = new class player(&multideck);
-    players.append(player2);
-
-    playerNum++;
-    addPlayer2->setText("+");
-    addPlayer2->setEnabled(false);
-
-}
-
-/**
- * @brief Adds the third player to the game.
+ * @brief Seats another player at the table.
  *
- * When the Add Player 3 button is clicked, this method creates a new player instance
- * and updates the UI and internal game state to include the new player.
+ * When the Add Player button is clicked, the next free seat is filled. Seats live in the
+ * table's fixed array, so nothing is allocated; the button is disabled once the table is full.
  */
-void GameUI::onAddPlayer3Clicked(){
-    player3 = new class player(&multideck);
-    players.append(player3);
-
-    playerNum++;
-    addPlayer3->setText("+");
-    addPlayer3->setEnabled(false);
+void GameUI::onAddPlayerClicked(){
+    if (table.addSeat()){
+        addPlayerButton->setText(QString("Add Player (%1)").arg(table.seatCount));
+    }
+    addPlayerButton->setEnabled(!table.isFull());
 }
 
 
@@ -868,7 +1059,7 @@ void GameUI::onAddPlayer3Clicked(){
 void GameUI::showPlayerActionButtons(){
 
 
-    if (playerNum >= 1){
+    if (table.seatCount >= 1){
         hitButton->show();
         standButton->show();
         doubleButton->show();
@@ -884,6 +1075,8 @@ void GameUI::hidePlayerActionButtons(){
     hitButton->hide();
     standButton->hide();
     doubleButton->hide();
+    splitButton->hide();
+    clearAdvice();
 
 }
 
@@ -891,98 +1084,122 @@ void GameUI::hidePlayerActionButtons(){
 /**
  * @brief Updates and displays the current hand values for all players.
  *
- * Concatenates the hand values of all players into a single string and updates the
- * playerHandValue1 QLabel to display these values. This allows players to see the total
- * value of their hands during the game.
+ * Shows each seat's hand value in that seat's label, placed under the seat's cards. This
+ * allows players to see the total value of their hands during the game. A seat that has
+ * split shows each hand's value, separated by " | ".
  */
 void GameUI::displayPlayerHandsValue(){
 
-    QString resultString;
     QString singleHandValue;
 
-    singleHandValue = players[0]->GetHandString();
-    resultString += "" + singleHandValue;
-
-    for (int i = 1; i < playerNum; i++){
-        singleHandValue = players[i]->GetHandString();
-        resultString += "                                                                                           " + singleHandValue;
+    for (int i = 0; i < table.seatCount; i++){
+        singleHandValue = playerHandText(table.seats[i].hands[0].value());
+        for (int h = 1; h < table.seats[i].handCount; h++){
+            singleHandValue += " | " + playerHandText(table.seats[i].hands[h].value());
+        }
+        seatHandValues[i]->setText(singleHandValue);
+        seatHandValues[i]->adjustSize();
+        seatHandValues[i]->move(seatX(i), 400);
+        seatHandValues[i]->show();
     }
 
-    playerHandValue1->setText(resultString);
-
 }
 
 /**
  * @brief Checks for a blackjack at the start of a hand.
  *
- * Iterates through each player's hand to check if they have blackjack (a hand value of 21).
- * If a player has blackjack, their hand is marked to skip further actions for this round.
+ * Moves currentPlayingHand past every seat, starting from the current one, that holds
+ * blackjack. Those seats have no decisions to make this round.
  */
 void GameUI::checkBJ(){
 
-    for (int i = 0; i < players.size(); i++){
-        if (players[i]->CheckHand().second == 21){
-            skiphand = i;
-            std::cout << "        NEWEST CHECK: this is used in checkBJ = "<< currentPlayingHand << std::endl;
+    while (currentPlayingHand < table.seatCount && table.seats[currentPlayingHand].HasBlackjack()){
+        LOG_DEBUG("Blackjack on hand %d, skipping it", currentPlayingHand);
+        currentPlayingHand ++;
+    }
+}
+
+/**
+ * @brief Offers insurance to every seat when the dealer shows an ace.
+ *
+ * A seat holding blackjack is offered even money instead, which costs nothing now and pays
+ * 1:1 whatever the dealer has. Insurance costs half the seat's bet and pays 2:1 if the
+ * dealer has blackjack; both are settled in onEndClicked.
+ */
+void GameUI::offerInsurance(){
+    bool ok;
+    double initialBetAmount = betAmount->text().toDouble(&ok);
+    if (!ok || initialBetAmount <= 0){
+        return;
+    }
 
+    for (int i = 0; i < table.seatCount; i++){
+        player *currentPlayer = &table.seats[i];
+        if (currentPlayer->HasBlackjack()){
+            QMessageBox::StandardButton answer = QMessageBox::question(this, "Even Money",
+                QString("Player %1 has blackjack against an ace. Take even money?").arg(i + 1));
+            currentPlayer->insured = (answer == QMessageBox::Yes);
+        }
+        else{
+            QMessageBox::StandardButton answer = QMessageBox::question(this, "Insurance",
+                QString("Player %1: take insurance for $%2?").arg(i + 1).arg(initialBetAmount / 2, 0, 'f', 2));
+            if (answer == QMessageBox::Yes && myWallet->placeBet(initialBetAmount / 2)){
+                currentPlayer->insured = true;
+            }
         }
     }
+    updateWalletBalanceLabel();
 }
 
 /**
  * @brief Ends the current player's turn and proceeds to the next actions.
  *
- * Increments the currentPlayingHand counter to move to the next player or end the hand if
- * all players have completed their turns. Also manages the layout margins for displaying
- * player hands and controls the visibility of action buttons based on the game state.
+ * Moves on to the current player's next split hand if there is one. Otherwise moves to
+ * the next seat without blackjack, bringing the action buttons under it, or plays the
+ * dealer's hand once every seat has completed its turn.
  */
 void GameUI::endHand(){
-
-    //std::cout << "              !!!!DEBUG CHECK: double down bool= "<< isDoubleDown << std::endl;
-
+    TRACE_SCOPE("GameUI::endHand");
 
     isDoubleDown = false;
 
-    currentPlayingHand ++;
-    std::cout << "        DEBUG CHECK: Current playing hand = "<< currentPlayingHand << std::endl;
-    std::cout << "              DEBUG CHECK: skiphand value = "<< skiphand << std::endl;
-
-    doubleButton->show();
-
+    if (currentPlayingHand < table.seatCount){
+        player *currentPlayer = &table.seats[currentPlayingHand];
+        while (currentPlayer->NextHand()){
+            // split aces that may not draw or split again have nothing to decide
+            if (!currentPlayer->CurrentHand().isSplitAces() || rules.hitSplitAces
+                || currentPlayer->CanSplit(rules.maxSplitHands, rules.resplitAces)){
+                updateActionButtons();
+                return;
+            }
+        }
+    }
 
+    currentPlayingHand ++;
+    checkBJ();
+    LOG_DEBUG("Current playing hand = %d", currentPlayingHand);
 
-    if ((currentPlayingHand == 0)&&(skiphand != 0)){
-        buttonsLayout->setContentsMargins(30, 0, 0, 100);
-    }
-    else if ((currentPlayingHand == 1)&&(skiphand != 1)){
-        buttonsLayout->setContentsMargins(300, 0, 0, 100);
-    }
-    else if(skiphand == 1){
-        buttonsLayout->setContentsMargins(600, 0, 0, 100);
-        currentPlayingHand ++;
-        skiphand = -1;
-    }
-    else if ((currentPlayingHand == 2)&&(skiphand != 2)){
-        buttonsLayout->setContentsMargins(600, 0, 0, 100);
-    }
-    else if(skiphand == 2){
-        hidePlayerActionButtons();
-        currentPlayingHand ++;
+    if (currentPlayingHand < table.seatCount){
+        moveButtonsToSeat(currentPlayingHand);
+        updateActionButtons();
     }
     else{
         hidePlayerActionButtons();
+        finishRound();
     }
+}
 
-    if (currentPlayingHand == playerNum){
-        showFaceDownCard();
-        dealer->PlayHand();
-        dealerReveal(); // Second reveal after dealer plays hand
-        displayResult();
-
-        onEndClicked();
-    }
 
+/**
+ * @brief Plays the dealer's hand once every seat is done and settles the round.
+ */
+void GameUI::finishRound(){
+    showFaceDownCard();
+    dealer->PlayHand(rules.hitSoft17);
+    dealerReveal(); // Second reveal after dealer plays hand
+    displayResult();
 
+    onEndClicked();
 }
 
 
@@ -1,9 +1,14 @@
 #include "headers/mainwindow.h"
+#include "headers/trace.h"
+#include "headers/metrics.h"
 
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    tracing::startFromEnvironment();
+    metrics::startFromEnvironment();
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
@@ -0,0 +1,44 @@
+#include "headers/qtadapter.h"
+
+/**
+ * @file qtadapter.cpp
+ * @brief Implementation of the Qt presentation helpers for the core game types.
+ */
+
+
+/// Combines the card's rank and suit into a single QString.
+/// @return A QString representation of the card.
+QString cardText(const Card& card) {
+    return QString("%1 of %2").arg(card.rankName(), card.suitName());
+}
+
+
+/// Generates the image path for a card based on its rank and suit.
+/// @return A QString representing the image path for the card.
+QString cardImagePath(const Card& card) {
+    return QString(":/images/%1_of_%2.png")
+        .arg(QString(card.rankName()).toLower(), QString(card.suitName()).toLower());
+}
+
+
+/**
+ * @brief Formats a player's hand value for display.
+ * @param value The evaluated hand.
+ * @return "low or high" for a soft hand below 21, otherwise the single best total.
+ */
+QString playerHandText(const HandValue& value) {
+    if (value.soft && value.total != 21) {
+        return QString::number(value.total - 10) + " or " + QString::number(value.total);
+    }
+    return QString::number(value.total);
+}
+
+
+/**
+ * @brief Formats the dealer's hand value for display.
+ * @param value The evaluated hand.
+ * @return The dealer's best total.
+ */
+QString dealerHandText(const HandValue& value) {
+    return QString::number(value.total);
+}
@@ -10,9 +10,12 @@
  */
 
 #include "headers/startmenu.h"
+#include "headers/deviations.h"
 
 #include <QMainWindow>
 
+#include <cstdlib>
+
 /**
  * @brief Constructs a StartMenu widget with a given parent and a wallet.
  * @param parent The parent widget of this StartMenu, defaults to nullptr.
@@ -94,7 +97,8 @@ void StartMenu::updateBalance() {
  * @brief Displays the optimal moves chart in a new window.
  * 
  * This method loads an image representing the optimal moves chart for blackjack
- * and displays it in a QLabel.
+ * and displays it in a QLabel. If BJ_INDEX_TABLE names an index table file (as written by
+ * bjsim indices), its count deviations are listed in a second window beside the chart.
  */
 void StartMenu::showChart() {
     QPixmap chartPixmap(":/images/moves.png");
@@ -108,6 +112,20 @@ void StartMenu::showChart() {
     imageLabel->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
     imageLabel->setFixedSize(chartPixmap.size());
     imageLabel->show();
+
+    const char *tablePath = std::getenv("BJ_INDEX_TABLE");
+    IndexTable table;
+    if (tablePath && table.load(tablePath)) {
+        QLabel *tableLabel = new QLabel(this);
+        tableLabel->setWindowTitle("Count Deviations");
+        tableLabel->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+        tableLabel->setText(QString::fromStdString(table.format()));
+        tableLabel->setMargin(10);
+        tableLabel->setWindowFlags(Qt::Window);
+        tableLabel->show();
+    } else if (tablePath) {
+        qDebug() << "Failed to load index table" << tablePath;
+    }
 }
 
 /**